@@ -0,0 +1,433 @@
+#include "adaptiveList.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ADAPTIVE_LIST_MIN_CAPACITY 16
+
+enum {
+  COST_LINKED,
+  COST_ARRAY,
+};
+
+static size_t gap_size(const struct adaptive_list *self) {
+  return self->gap_end - self->gap_begin;
+}
+
+static int *array_at(struct adaptive_list *self, size_t index) {
+  return &self->buffer[index < self->gap_begin ? index : index + gap_size(self)];
+}
+
+static void array_move_gap(struct adaptive_list *self, size_t index) {
+  if(index < self->gap_begin){
+    size_t count = self->gap_begin - index;
+    memmove(&self->buffer[self->gap_end - count], &self->buffer[index], count * sizeof(int));
+    self->gap_begin -= count;
+    self->gap_end -= count;
+  }
+  else if(index > self->gap_begin){
+    size_t count = index - self->gap_begin;
+    memmove(&self->buffer[self->gap_begin], &self->buffer[self->gap_end], count * sizeof(int));
+    self->gap_begin += count;
+    self->gap_end += count;
+  }
+}
+
+/*
+ * Copy the values in a new buffer of capacity, keeping the gap where it is
+ */
+static bool array_reallocate(struct adaptive_list *self, size_t capacity) {
+  int *buffer = malloc(capacity * sizeof(int));
+  if(buffer == NULL) return false;
+  size_t after = self->size - self->gap_begin;
+  if(self->gap_begin > 0){
+    memcpy(buffer, self->buffer, self->gap_begin * sizeof(int));
+  }
+  if(after > 0){
+    memcpy(&buffer[capacity - after], &self->buffer[self->gap_end], after * sizeof(int));
+  }
+  free(self->buffer);
+  self->buffer = buffer;
+  self->capacity = capacity;
+  self->gap_end = capacity - after;
+  return true;
+}
+
+/*
+ * Estimated costs, in array value reads
+ */
+static size_t linked_cost(const struct adaptive_list *self, size_t index) {
+  return self->tuning.node_cost * (index + 1);
+}
+
+static size_t array_cost(const struct adaptive_list *self, size_t index) {
+  size_t distance = (index < self->gap_begin) ? self->gap_begin - index : index - self->gap_begin;
+  return 1 + distance / self->tuning.move_divisor;
+}
+
+static size_t sort_levels(size_t size) {
+  size_t levels = 1;
+  while(size > 1){
+    size /= 2;
+    ++levels;
+  }
+  return levels;
+}
+
+static bool adaptive_to_array(struct adaptive_list *self) {
+  // destroying the struct list would drop what the caller attached to it
+  if(self->linked.index != NULL || self->linked.fingerprint != NULL) return false;
+  size_t capacity = self->size + self->size / 2 + ADAPTIVE_LIST_MIN_CAPACITY;
+  int *buffer = malloc(capacity * sizeof(int));
+  if(buffer == NULL) return false;
+  size_t gap = capacity - self->size;
+  size_t i = 0;
+  for(struct list_node *curr = self->linked.first; curr != NULL; curr = curr->next){
+    buffer[i < self->gap_begin ? i : i + gap] = curr->data;
+    ++i;
+  }
+  list_destroy(&self->linked);
+  self->buffer = buffer;
+  self->capacity = capacity;
+  self->gap_end = self->gap_begin + gap;
+  self->contiguous = true;
+  return true;
+}
+
+/*
+ * The whole chain is built before the buffer is freed, so that an
+ * allocation failure leaves the list as it was
+ */
+static bool adaptive_to_linked(struct adaptive_list *self) {
+  struct list_node *first = NULL;
+  struct list_node **link = &first;
+  for(size_t i=0; i<self->size; ++i){
+    struct list_node *new = list_node_try_create(&self->linked, *array_at(self, i));
+    if(new == NULL){
+      *link = NULL;
+      while(first != NULL){
+        struct list_node *next = first->next;
+        list_node_destroy(&self->linked, first);
+        first = next;
+      }
+      return false;
+    }
+    *link = new;
+    link = &new->next;
+  }
+  *link = NULL;
+  self->linked.first = first;
+  list_relinked(&self->linked);
+  free(self->buffer);
+  self->buffer = NULL;
+  self->capacity = 0;
+  self->gap_end = self->gap_begin;
+  self->contiguous = false;
+  return true;
+}
+
+static void adaptive_reset_window(struct adaptive_list *self) {
+  self->window_operations = 0;
+  memset(self->window_costs, 0, sizeof(self->window_costs));
+}
+
+static void adaptive_migrated(struct adaptive_list *self, enum adaptive_list_reason reason) {
+  if(self->contiguous){
+    ++self->stats.to_array;
+  }
+  else{
+    ++self->stats.to_linked;
+  }
+  ++self->stats.migrations[reason];
+  self->stats.last_migration = self->stats.operations;
+  self->stats.last_reason = reason;
+}
+
+/*
+ * End of a window: migrate if the other representation would have been
+ * cheaper, the reason is the kind of operation that gained the most
+ */
+static void adaptive_decide(struct adaptive_list *self) {
+  unsigned current = self->contiguous ? COST_ARRAY : COST_LINKED;
+  unsigned other = self->contiguous ? COST_LINKED : COST_ARRAY;
+  size_t current_cost = 0;
+  size_t other_cost = 0;
+  enum adaptive_list_reason reason = ADAPTIVE_LIST_REASON_NONE;
+  long long best_gain = 0;
+  for(unsigned i=0; i<ADAPTIVE_LIST_REASONS; ++i){
+    current_cost += self->window_costs[i][current];
+    other_cost += self->window_costs[i][other];
+    long long gain = (long long)self->window_costs[i][current] - (long long)self->window_costs[i][other];
+    if(gain > best_gain){
+      best_gain = gain;
+      reason = (enum adaptive_list_reason)i;
+    }
+  }
+  adaptive_reset_window(self);
+
+  if(!self->contiguous && self->size < self->tuning.min_size) return;
+  size_t migration = self->size * (self->tuning.node_cost + 1);
+  if((other_cost + migration) * (100 + self->tuning.hysteresis) >= current_cost * 100) return;
+  bool migrated = self->contiguous ? adaptive_to_linked(self) : adaptive_to_array(self);
+  if(!migrated) return;
+  adaptive_migrated(self, reason);
+}
+
+static void adaptive_account(struct adaptive_list *self, enum adaptive_list_reason reason, size_t linked, size_t array) {
+  self->window_costs[reason][COST_LINKED] += linked;
+  self->window_costs[reason][COST_ARRAY] += array;
+  ++self->stats.operations;
+  switch(reason){
+  case ADAPTIVE_LIST_REASON_INDEXED:
+    ++self->stats.indexed;
+    break;
+  case ADAPTIVE_LIST_REASON_SPLICES:
+    ++self->stats.splices;
+    break;
+  default:
+    ++self->stats.traversals;
+    break;
+  }
+  if(++self->window_operations >= self->tuning.window){
+    adaptive_decide(self);
+  }
+}
+
+/*
+ * The struct list given by adaptive_list_list may have been changed
+ */
+static void adaptive_sync(struct adaptive_list *self) {
+  if(!self->lent) return;
+  self->lent = false;
+  self->size = list_size(&self->linked);
+  if(self->gap_begin > self->size){
+    self->gap_begin = self->size;
+  }
+  self->gap_end = self->gap_begin;
+}
+
+struct adaptive_list_tuning adaptive_list_default_tuning(void) {
+  struct adaptive_list_tuning tuning;
+  tuning.window = 64;
+  tuning.min_size = 32;
+  tuning.node_cost = 4;
+  tuning.move_divisor = 16;
+  tuning.hysteresis = 25;
+  return tuning;
+}
+
+void adaptive_list_create(struct adaptive_list *self) {
+  struct adaptive_list_tuning tuning = adaptive_list_default_tuning();
+  adaptive_list_create_with_tuning(self, &tuning);
+}
+
+void adaptive_list_create_with_tuning(struct adaptive_list *self, const struct adaptive_list_tuning *tuning) {
+  self->contiguous = false;
+  self->lent = false;
+  list_create(&self->linked);
+  self->buffer = NULL;
+  self->capacity = 0;
+  self->gap_begin = 0;
+  self->gap_end = 0;
+  self->size = 0;
+  self->tuning = *tuning;
+  if(self->tuning.window == 0){
+    self->tuning.window = 1;
+  }
+  if(self->tuning.move_divisor == 0){
+    self->tuning.move_divisor = 1;
+  }
+  memset(&self->stats, 0, sizeof(self->stats));
+  adaptive_reset_window(self);
+}
+
+void adaptive_list_create_from(struct adaptive_list *self, const int *other, size_t size) {
+  adaptive_list_create(self);
+  list_create_from(&self->linked, other, size);
+  self->size = size;
+  self->gap_begin = size;
+  self->gap_end = size;
+}
+
+void adaptive_list_destroy(struct adaptive_list *self) {
+  list_destroy(&self->linked);
+  free(self->buffer);
+  self->buffer = NULL;
+  self->capacity = 0;
+  self->contiguous = false;
+  self->lent = false;
+  self->size = 0;
+  self->gap_begin = 0;
+  self->gap_end = 0;
+}
+
+bool adaptive_list_contiguous(const struct adaptive_list *self) {
+  return self->contiguous;
+}
+
+struct list *adaptive_list_list(struct adaptive_list *self) {
+  adaptive_sync(self);
+  if(self->contiguous){
+    if(!adaptive_to_linked(self)) return NULL;
+    adaptive_migrated(self, ADAPTIVE_LIST_REASON_LIST);
+    adaptive_reset_window(self);
+  }
+  self->lent = true;
+  return &self->linked;
+}
+
+const struct adaptive_list_stats *adaptive_list_stats(const struct adaptive_list *self) {
+  return &self->stats;
+}
+
+bool adaptive_list_empty(const struct adaptive_list *self) {
+  return adaptive_list_size(self) == 0;
+}
+
+size_t adaptive_list_size(const struct adaptive_list *self) {
+  if(self->lent) return list_size(&self->linked);
+  return self->size;
+}
+
+bool adaptive_list_equals(struct adaptive_list *self, const int *data, size_t size) {
+  adaptive_sync(self);
+  if(self->size != size) return false;
+  bool equal;
+  if(self->contiguous){
+    size_t before = self->gap_begin;
+    equal = (before == 0 || memcmp(self->buffer, data, before * sizeof(int)) == 0)
+      && (before == size || memcmp(&self->buffer[self->gap_end], &data[before], (size - before) * sizeof(int)) == 0);
+  }
+  else{
+    equal = list_equals(&self->linked, data, size);
+  }
+  adaptive_account(self, ADAPTIVE_LIST_REASON_TRAVERSALS, self->tuning.node_cost * size, size);
+  return equal;
+}
+
+void adaptive_list_push_front(struct adaptive_list *self, int value) {
+  adaptive_list_insert(self, value, 0);
+}
+
+void adaptive_list_pop_front(struct adaptive_list *self) {
+  if(adaptive_list_empty(self)) return;
+  adaptive_list_remove(self, 0);
+}
+
+void adaptive_list_push_back(struct adaptive_list *self, int value) {
+  adaptive_list_insert(self, value, adaptive_list_size(self));
+}
+
+void adaptive_list_pop_back(struct adaptive_list *self) {
+  if(adaptive_list_empty(self)) return;
+  adaptive_list_remove(self, adaptive_list_size(self) - 1);
+}
+
+void adaptive_list_insert(struct adaptive_list *self, int value, size_t index) {
+  adaptive_sync(self);
+  assert(index <= self->size);
+  size_t linked = linked_cost(self, index);
+  size_t array = array_cost(self, index);
+  if(self->contiguous){
+    if(gap_size(self) == 0 && !array_reallocate(self, 2 * self->capacity)) return;
+    array_move_gap(self, index);
+    self->buffer[self->gap_begin] = value;
+    ++self->gap_begin;
+  }
+  else{
+    list_insert(&self->linked, value, index);
+    self->gap_begin = index + 1;
+    self->gap_end = self->gap_begin;
+  }
+  ++self->size;
+  adaptive_account(self, ADAPTIVE_LIST_REASON_SPLICES, linked, array);
+}
+
+void adaptive_list_remove(struct adaptive_list *self, size_t index) {
+  adaptive_sync(self);
+  assert(index < self->size);
+  size_t linked = linked_cost(self, index);
+  size_t array = array_cost(self, index);
+  if(self->contiguous){
+    array_move_gap(self, index);
+    ++self->gap_end;
+  }
+  else{
+    list_remove(&self->linked, index);
+    self->gap_begin = index;
+    self->gap_end = index;
+  }
+  --self->size;
+  adaptive_account(self, ADAPTIVE_LIST_REASON_SPLICES, linked, array);
+}
+
+int adaptive_list_get(struct adaptive_list *self, size_t index) {
+  adaptive_sync(self);
+  if(index >= self->size) return 0;
+  int value = self->contiguous ? *array_at(self, index) : list_get(&self->linked, index);
+  adaptive_account(self, ADAPTIVE_LIST_REASON_INDEXED, linked_cost(self, index), 1);
+  return value;
+}
+
+void adaptive_list_set(struct adaptive_list *self, size_t index, int value) {
+  adaptive_sync(self);
+  if(index >= self->size) return;
+  if(self->contiguous){
+    *array_at(self, index) = value;
+  }
+  else{
+    list_set(&self->linked, index, value);
+  }
+  adaptive_account(self, ADAPTIVE_LIST_REASON_INDEXED, linked_cost(self, index), 1);
+}
+
+size_t adaptive_list_search(struct adaptive_list *self, int value) {
+  adaptive_sync(self);
+  size_t index = 0;
+  if(self->contiguous){
+    while(index < self->size && *array_at(self, index) != value){
+      ++index;
+    }
+  }
+  else{
+    index = list_search(&self->linked, value);
+  }
+  adaptive_account(self, ADAPTIVE_LIST_REASON_TRAVERSALS, linked_cost(self, index), index + 1);
+  return index;
+}
+
+bool adaptive_list_is_sorted(struct adaptive_list *self) {
+  adaptive_sync(self);
+  bool sorted = true;
+  if(self->contiguous){
+    for(size_t i=1; i<self->size && sorted; ++i){
+      sorted = *array_at(self, i - 1) <= *array_at(self, i);
+    }
+  }
+  else{
+    sorted = list_is_sorted(&self->linked);
+  }
+  adaptive_account(self, ADAPTIVE_LIST_REASON_TRAVERSALS, self->tuning.node_cost * self->size, self->size);
+  return sorted;
+}
+
+static int adaptive_compare(const void *lhs, const void *rhs) {
+  int a = *(const int *)lhs;
+  int b = *(const int *)rhs;
+  return (a > b) - (a < b);
+}
+
+void adaptive_list_merge_sort(struct adaptive_list *self) {
+  adaptive_sync(self);
+  size_t levels = sort_levels(self->size);
+  if(self->contiguous){
+    // equal ints cannot be told apart, the sort does not need to be stable
+    array_move_gap(self, self->size);
+    qsort(self->buffer, self->size, sizeof(int), adaptive_compare);
+  }
+  else{
+    list_merge_sort(&self->linked);
+  }
+  adaptive_account(self, ADAPTIVE_LIST_REASON_TRAVERSALS, self->tuning.node_cost * self->size * levels, self->size * levels);
+}
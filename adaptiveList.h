@@ -0,0 +1,131 @@
+#ifndef ADAPTIVE_LIST_H
+#define ADAPTIVE_LIST_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * List switching between a struct list and a gap buffer (a contiguous
+ * array with a hole at the last insertion or removal point) depending on
+ * how it is used. Every operation adds its estimated cost in both
+ * representations to a window; at the end of a window, the list migrates
+ * if the other representation would have been cheaper by the hysteresis,
+ * the migration itself included.
+ */
+struct adaptive_list_tuning {
+  size_t window;         // operations between two decisions
+  size_t min_size;       // smaller lists never become arrays
+  size_t node_cost;      // cost of visiting a node, reading an array value costs 1
+  size_t move_divisor;   // number of values moved by memmove for a cost of 1
+  size_t hysteresis;     // percent the other representation must be cheaper by
+};
+
+enum adaptive_list_reason {
+  ADAPTIVE_LIST_REASON_NONE,
+  ADAPTIVE_LIST_REASON_INDEXED,    // get and set
+  ADAPTIVE_LIST_REASON_SPLICES,    // insertions and removals, ends included
+  ADAPTIVE_LIST_REASON_TRAVERSALS, // search, comparison, sort
+  ADAPTIVE_LIST_REASON_LIST,       // adaptive_list_list was called
+  ADAPTIVE_LIST_REASONS,
+};
+
+struct adaptive_list_stats {
+  size_t operations;
+  size_t indexed;
+  size_t splices;
+  size_t traversals;
+  size_t to_array;
+  size_t to_linked;
+  size_t migrations[ADAPTIVE_LIST_REASONS]; // per reason
+  size_t last_migration;                   // operations before the last migration
+  enum adaptive_list_reason last_reason;
+};
+
+struct adaptive_list {
+  bool contiguous;
+  bool lent; // the struct list was given by adaptive_list_list, size may be stale
+  struct list linked;
+  int *buffer;
+  size_t capacity;
+  size_t gap_begin; // where the gap would be while linked
+  size_t gap_end;
+  size_t size;
+  size_t window_operations;
+  size_t window_costs[ADAPTIVE_LIST_REASONS][2]; // linked, array
+  struct adaptive_list_tuning tuning;
+  struct adaptive_list_stats stats;
+};
+
+/*
+ * Get the default tuning, measured with bench adaptive
+ */
+struct adaptive_list_tuning adaptive_list_default_tuning(void);
+
+/*
+ * Create an empty adaptive list, linked, with the default tuning
+ */
+void adaptive_list_create(struct adaptive_list *self);
+
+/*
+ * Create an empty adaptive list, linked, with a tuning
+ */
+void adaptive_list_create_with_tuning(struct adaptive_list *self, const struct adaptive_list_tuning *tuning);
+
+/*
+ * Create an adaptive list with initial content
+ */
+void adaptive_list_create_from(struct adaptive_list *self, const int *other, size_t size);
+
+/*
+ * Destroy an adaptive list
+ */
+void adaptive_list_destroy(struct adaptive_list *self);
+
+/*
+ * Tell if the values are in the gap buffer
+ */
+bool adaptive_list_contiguous(const struct adaptive_list *self);
+
+/*
+ * Get the list as a struct list, migrating it if needed, return NULL (and
+ * leave the list as it is) if the allocation failed. The struct list can be
+ * used with any function of linkedList.h until the next call on the
+ * adaptive list. While an index or a fingerprint is attached to it, the
+ * list stays linked.
+ */
+struct list *adaptive_list_list(struct adaptive_list *self);
+
+/*
+ * Get the counters, they tell when and why the list migrated
+ */
+const struct adaptive_list_stats *adaptive_list_stats(const struct adaptive_list *self);
+
+/*
+ * Same contracts as the functions of linkedList.h
+ */
+bool adaptive_list_empty(const struct adaptive_list *self);
+size_t adaptive_list_size(const struct adaptive_list *self);
+bool adaptive_list_equals(struct adaptive_list *self, const int *data, size_t size);
+void adaptive_list_push_front(struct adaptive_list *self, int value);
+void adaptive_list_pop_front(struct adaptive_list *self);
+void adaptive_list_push_back(struct adaptive_list *self, int value);
+void adaptive_list_pop_back(struct adaptive_list *self);
+void adaptive_list_insert(struct adaptive_list *self, int value, size_t index);
+void adaptive_list_remove(struct adaptive_list *self, size_t index);
+int adaptive_list_get(struct adaptive_list *self, size_t index);
+void adaptive_list_set(struct adaptive_list *self, size_t index, int value);
+size_t adaptive_list_search(struct adaptive_list *self, int value);
+bool adaptive_list_is_sorted(struct adaptive_list *self);
+void adaptive_list_merge_sort(struct adaptive_list *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADAPTIVE_LIST_H
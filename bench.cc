@@ -0,0 +1,1041 @@
+/*
+ * Benchmarks for the list engine.
+ *
+ * Usage: bench <name> [args...]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "linkedList.h"
+#include "listQueue.h"
+#include "nodeArena.h"
+#include "parallelList.h"
+#include "smallList.h"
+#include "listIndex.h"
+#include "listSelect.h"
+#include "listReorder.h"
+#include "nodeCache.h"
+#include "rcuList.h"
+#include "listFingerprint.h"
+#include "listCache.h"
+#include "adaptiveList.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using bench_clock = std::chrono::steady_clock;
+
+static double seconds_since(bench_clock::time_point start) {
+  return std::chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+static std::uint64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * queue: producers -> one consumer, list with a mutex vs MPSC vs SPSC
+ */
+
+// the node is the first member, so a list_node * is also a bench_item *
+struct bench_item {
+  struct list_node node;
+  std::uint64_t stamp;
+};
+
+struct queue_result {
+  double seconds;
+  double mean_latency_ns;
+};
+
+template<typename Push, typename Pop>
+static queue_result run_queue(int producers, int per_producer, Push push, Pop pop) {
+  std::atomic<bool> go(false);
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      while (!go.load()) {
+        std::this_thread::yield();
+      }
+      for (int i = 0; i < per_producer; ++i) {
+        bench_item *item = static_cast<bench_item *>(std::malloc(sizeof(bench_item)));
+        item->node.data = p;
+        item->node.next = nullptr;
+        item->stamp = now_ns();
+        push(p, item);
+      }
+    });
+  }
+
+  long total = static_cast<long>(producers) * per_producer;
+  double latency = 0;
+  auto start = bench_clock::now();
+  go.store(true);
+  for (long received = 0; received < total;) {
+    bench_item *item = pop();
+    if (item == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    latency += static_cast<double>(now_ns() - item->stamp);
+    std::free(item);
+    ++received;
+  }
+  double elapsed = seconds_since(start);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return { elapsed, latency / total };
+}
+
+static void bench_queue(int argc, char *argv[]) {
+  int per_producer = argc > 0 ? std::atoi(argv[0]) : 200000;
+
+  std::printf("%-10s %9s %14s %14s\n", "queue", "producers", "Mops/s", "latency (ns)");
+
+  for (int producers : { 1, 2, 4, 8 }) {
+    long total = static_cast<long>(producers) * per_producer;
+
+    std::mutex mutex;
+    struct list l;
+    list_create(&l);
+    queue_result locked = run_queue(producers, per_producer,
+      [&](int, bench_item *item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        struct list_node **link = &l.first;
+        while (*link != nullptr) {
+          link = &(*link)->next;
+        }
+        *link = &item->node;
+      },
+      [&]() -> bench_item * {
+        std::lock_guard<std::mutex> lock(mutex);
+        struct list_node *node = l.first;
+        if (node != nullptr) {
+          l.first = node->next;
+        }
+        return reinterpret_cast<bench_item *>(node);
+      });
+    std::printf("%-10s %9d %14.2f %14.0f\n", "mutex", producers, total / locked.seconds / 1e6, locked.mean_latency_ns);
+
+    struct list_mpsc_queue mpsc;
+    list_mpsc_create(&mpsc);
+    queue_result lock_free = run_queue(producers, per_producer,
+      [&](int, bench_item *item) { list_mpsc_push(&mpsc, &item->node); },
+      [&]() { return reinterpret_cast<bench_item *>(list_mpsc_pop(&mpsc)); });
+    list_mpsc_destroy(&mpsc, nullptr);
+    std::printf("%-10s %9d %14.2f %14.0f\n", "mpsc", producers, total / lock_free.seconds / 1e6, lock_free.mean_latency_ns);
+
+    if (producers == 1) {
+      struct list_spsc_queue spsc;
+      list_spsc_create(&spsc, 1024);
+      queue_result ring = run_queue(producers, per_producer,
+        [&](int, bench_item *item) {
+          while (!list_spsc_push(&spsc, &item->node)) {
+            std::this_thread::yield();
+          }
+        },
+        [&]() { return reinterpret_cast<bench_item *>(list_spsc_pop(&spsc)); });
+      list_spsc_destroy(&spsc, nullptr);
+      std::printf("%-10s %9d %14.2f %14.0f\n", "spsc", producers, total / ring.seconds / 1e6, ring.mean_latency_ns);
+    }
+  }
+}
+
+/*
+ * arena: traversal of a list whose nodes are linked in random order, nodes
+ * from malloc vs from an arena with and without huge pages
+ */
+
+// counts dTLB load misses of the calling thread, or reports -1 when perf events are not available
+class tlb_counter {
+public:
+  tlb_counter() {
+#if defined(__linux__)
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  ~tlb_counter() {
+#if defined(__linux__)
+    if (fd >= 0) {
+      close(fd);
+    }
+#endif
+  }
+
+  void start() {
+#if defined(__linux__)
+    if (fd >= 0) {
+      ioctl_reset();
+    }
+#endif
+  }
+
+  long long stop() {
+#if defined(__linux__)
+    long long count = 0;
+    if (fd >= 0 && read(fd, &count, sizeof(count)) == sizeof(count)) {
+      return count;
+    }
+#endif
+    return -1;
+  }
+
+private:
+  void ioctl_reset();
+
+  int fd = -1;
+};
+
+#if defined(__linux__)
+#include <sys/ioctl.h>
+
+void tlb_counter::ioctl_reset() {
+  ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+#else
+void tlb_counter::ioctl_reset() {
+}
+#endif
+
+static void shuffle_links(struct list *l, std::size_t size) {
+  std::vector<struct list_node *> nodes;
+  nodes.reserve(size);
+  for (struct list_node *curr = l->first; curr != nullptr; curr = curr->next) {
+    nodes.push_back(curr);
+  }
+  std::shuffle(nodes.begin(), nodes.end(), std::mt19937(42));
+  for (std::size_t i = 0; i + 1 < nodes.size(); ++i) {
+    nodes[i]->next = nodes[i + 1];
+  }
+  nodes.back()->next = nullptr;
+  l->first = nodes.front();
+}
+
+static void bench_arena_case(const char *name, const struct list_allocator *allocator, std::size_t size) {
+  struct list l;
+  list_create_with_allocator(&l, allocator);
+  for (std::size_t i = 0; i < size; ++i) {
+    list_push_front(&l, static_cast<int>(i));
+  }
+  shuffle_links(&l, size);
+
+  tlb_counter tlb;
+  double best = 1e30;
+  long long misses = -1;
+  for (int run = 0; run < 3; ++run) {
+    tlb.start();
+    auto start = bench_clock::now();
+    long long sum = 0;
+    for (struct list_node *curr = l.first; curr != nullptr; curr = curr->next) {
+      sum += curr->data;
+    }
+    double elapsed = seconds_since(start);
+    long long count = tlb.stop();
+    if (sum != static_cast<long long>(size * (size - 1) / 2)) {
+      std::printf("unexpected traversal result\n");
+    }
+    if (elapsed < best) {
+      best = elapsed;
+      misses = count;
+    }
+  }
+
+  std::printf("%-24s %12.1f %16lld\n", name, best * 1e9 / size, misses);
+
+  list_destroy(&l);
+}
+
+static void bench_arena(int argc, char *argv[]) {
+  std::size_t size = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 10000000;
+  int numa_node = argc > 1 ? std::atoi(argv[1]) : 0;
+
+  std::printf("%-24s %12s %16s\n", "allocator", "ns / node", "dTLB misses");
+
+  bench_arena_case("malloc", nullptr, size);
+
+  struct {
+    const char *name;
+    unsigned features;
+  } cases[] = {
+    { "arena", 0 },
+    { "arena + THP", LIST_ARENA_TRANSPARENT_HUGE_PAGES },
+    { "arena + hugetlb", LIST_ARENA_HUGE_PAGES },
+    { "arena + THP + NUMA bind", LIST_ARENA_TRANSPARENT_HUGE_PAGES | LIST_ARENA_NUMA_BIND },
+  };
+
+  for (auto &c : cases) {
+    struct list_node_arena arena;
+    list_node_arena_create(&arena, 0, c.features, numa_node);
+    if (list_node_arena_features(&arena) != c.features) {
+      std::printf("%-24s %12s %16s\n", c.name, "unavailable", "-");
+    } else {
+      bench_arena_case(c.name, &arena.allocator, size);
+    }
+    list_node_arena_destroy(&arena);
+  }
+}
+
+/*
+ * parallel: scaling of the parallel algorithms with the number of threads
+ */
+
+static bool bench_is_even(int value, void *) {
+  return value % 2 == 0;
+}
+
+static int bench_increment(int value, void *) {
+  return value + 1;
+}
+
+static void bench_parallel(int argc, char *argv[]) {
+  std::size_t size = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 100000000;
+  std::size_t max_threads = std::thread::hardware_concurrency();
+  if (max_threads == 0) {
+    max_threads = 1;
+  }
+
+  // 16 bytes per node instead of the malloc overhead
+  struct list_node_arena arena;
+  list_node_arena_create(&arena, 0, LIST_ARENA_TRANSPARENT_HUGE_PAGES, -1);
+  struct list l;
+  list_create_with_allocator(&l, &arena.allocator);
+  for (std::size_t i = 0; i < size; ++i) {
+    list_push_front(&l, static_cast<int>(i & 0xffff));
+  }
+
+  std::printf("%-8s %10s %10s %10s %10s %10s\n", "threads", "sum (s)", "min/max", "count_if", "transform", "filter");
+
+  for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+    struct list_thread_pool *pool = list_thread_pool_create(threads);
+
+    auto start = bench_clock::now();
+    volatile long long sum = list_parallel_sum(&l, pool);
+    double sum_time = seconds_since(start);
+    (void)sum;
+
+    int min, max;
+    start = bench_clock::now();
+    list_parallel_min_max(&l, pool, &min, &max);
+    double min_max_time = seconds_since(start);
+
+    start = bench_clock::now();
+    volatile std::size_t count = list_parallel_count_if(&l, pool, bench_is_even, nullptr);
+    double count_time = seconds_since(start);
+    (void)count;
+
+    start = bench_clock::now();
+    list_parallel_transform(&l, pool, bench_increment, nullptr);
+    double transform_time = seconds_since(start);
+
+    struct list evens;
+    list_create_with_allocator(&evens, &arena.allocator);
+    start = bench_clock::now();
+    list_parallel_filter(&l, &evens, pool, bench_is_even, nullptr);
+    double filter_time = seconds_since(start);
+
+    // put the nodes back for the next round
+    struct list_node **link = &l.first;
+    while (*link != nullptr) {
+      link = &(*link)->next;
+    }
+    *link = evens.first;
+
+    std::printf("%-8zu %10.3f %10.3f %10.3f %10.3f %10.3f\n", threads, sum_time, min_max_time, count_time, transform_time, filter_time);
+
+    list_thread_pool_destroy(pool);
+  }
+
+  list_destroy(&l);
+  list_node_arena_destroy(&arena);
+}
+
+/*
+ * small: build and destroy many lists whose sizes are skewed toward tiny
+ * lists, struct list vs small_list
+ */
+
+static void bench_small(int argc, char *argv[]) {
+  std::size_t count = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 1000000;
+
+  // geometric distribution: half of the lists have at most 2 elements
+  std::mt19937 gen(7);
+  std::geometric_distribution<int> distribution(0.3);
+  std::vector<int> sizes(count);
+  std::size_t total = 0;
+  for (auto &size : sizes) {
+    size = std::min(distribution(gen), 64);
+    total += size;
+  }
+
+  auto start = bench_clock::now();
+  for (int size : sizes) {
+    struct list l;
+    list_create(&l);
+    for (int i = 0; i < size; ++i) {
+      list_push_front(&l, i);
+    }
+    volatile std::size_t found = list_search(&l, size / 2);
+    (void)found;
+    list_destroy(&l);
+  }
+  double list_time = seconds_since(start);
+
+  start = bench_clock::now();
+  for (int size : sizes) {
+    struct small_list l;
+    small_list_create(&l);
+    for (int i = 0; i < size; ++i) {
+      small_list_push_front(&l, i);
+    }
+    volatile std::size_t found = small_list_search(&l, size / 2);
+    (void)found;
+    small_list_destroy(&l);
+  }
+  double small_time = seconds_since(start);
+
+  std::printf("%zu lists, %zu elements\n", count, total);
+  std::printf("%-12s %10s\n", "list", "time (s)");
+  std::printf("%-12s %10.3f\n", "struct list", list_time);
+  std::printf("%-12s %10.3f\n", "small_list", small_time);
+}
+
+/*
+ * index: list_search with and without a hash index, and what the index
+ * costs in memory, on push_front and on an insertion near the front
+ */
+
+static void bench_index(int argc, char *argv[]) {
+  std::size_t size = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 100000;
+  std::size_t lookups = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+
+  std::mt19937 gen(36);
+  std::uniform_int_distribution<int> distribution(0, int(size));
+  std::vector<int> values(size);
+  for (auto &value : values) {
+    value = distribution(gen);
+  }
+  std::vector<int> keys(lookups);
+  for (auto &key : keys) {
+    key = distribution(gen);
+  }
+
+  struct list plain;
+  struct list indexed;
+  list_create(&plain);
+  list_create(&indexed);
+  list_index_attach(&indexed);
+
+  auto start = bench_clock::now();
+  for (int value : values) {
+    list_push_front(&plain, value);
+  }
+  double plain_push_time = seconds_since(start);
+  start = bench_clock::now();
+  for (int value : values) {
+    list_push_front(&indexed, value);
+  }
+  double indexed_push_time = seconds_since(start);
+
+  std::size_t checksum = 0;
+  start = bench_clock::now();
+  for (int key : keys) {
+    checksum += list_search(&plain, key);
+  }
+  double plain_search_time = seconds_since(start);
+  start = bench_clock::now();
+  for (int key : keys) {
+    checksum -= list_search(&indexed, key);
+  }
+  double indexed_search_time = seconds_since(start);
+
+  // the index has to shift the positions after an insertion, the list only walks one node
+  start = bench_clock::now();
+  for (int key : keys) {
+    list_insert(&plain, key, 1);
+  }
+  double plain_insert_time = seconds_since(start);
+  start = bench_clock::now();
+  for (int key : keys) {
+    list_insert(&indexed, key, 1);
+  }
+  double indexed_insert_time = seconds_since(start);
+
+  std::printf("%zu elements, %zu lookups and inserts at 1 (checksum %zu)\n", size, lookups, checksum);
+  std::printf("%-8s %12s %16s %16s %14s\n", "list", "push (s)", "lookups/s", "inserts/s", "memory (B)");
+  std::printf("%-8s %12.3f %16.0f %16.0f %14zu\n", "plain", plain_push_time, lookups / plain_search_time,
+              lookups / plain_insert_time, size * sizeof(struct list_node));
+  std::printf("%-8s %12.3f %16.0f %16.0f %14zu\n", "indexed", indexed_push_time, lookups / indexed_search_time,
+              lookups / indexed_insert_time, size * sizeof(struct list_node) + list_index_memory(&indexed));
+
+  list_destroy(&plain);
+  list_destroy(&indexed);
+}
+
+/*
+ * select: median and top 100 with order statistics vs a full merge sort
+ */
+
+static void bench_select(int argc, char *argv[]) {
+  std::size_t size = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 10000;
+  std::size_t k = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+
+  std::mt19937 gen(37);
+  std::vector<int> values(size);
+  for (auto &value : values) {
+    value = int(gen() % 1000000);
+  }
+  std::vector<int> top(k);
+
+  struct list l;
+  list_create_from(&l, values.data(), values.size());
+  auto start = bench_clock::now();
+  list_merge_sort(&l);
+  int sorted_median = list_get(&l, size / 2);
+  for (std::size_t i = 0; i < k && i < size; ++i) {
+    top[i] = list_get(&l, size - 1 - i);
+  }
+  double sort_time = seconds_since(start);
+  list_destroy(&l);
+
+  list_create_from(&l, values.data(), values.size());
+  start = bench_clock::now();
+  int median = list_nth_element(&l, size / 2);
+  double nth_time = seconds_since(start);
+  start = bench_clock::now();
+  list_top_k(&l, top.data(), k);
+  double top_time = seconds_since(start);
+  start = bench_clock::now();
+  list_partial_sort(&l, k);
+  double partial_time = seconds_since(start);
+  list_destroy(&l);
+
+  std::printf("%zu elements, k = %zu, median %d / %d\n", size, k, median, sorted_median);
+  std::printf("%-22s %10s\n", "operation", "time (s)");
+  std::printf("%-22s %10.4f\n", "merge_sort + get", sort_time);
+  std::printf("%-22s %10.4f\n", "nth_element", nth_time);
+  std::printf("%-22s %10.4f\n", "top_k", top_time);
+  std::printf("%-22s %10.4f\n", "partial_sort", partial_time);
+}
+
+/*
+ * reorder: relinking reverse, rotate, partition and shuffle on a big list
+ */
+
+static bool bench_is_odd(int value, void *) {
+  return value % 2 != 0;
+}
+
+static void bench_reorder(int argc, char *argv[]) {
+  std::size_t size = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 1000000;
+
+  std::vector<int> values(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    values[i] = int(i);
+  }
+  struct list l;
+  list_create_from(&l, values.data(), values.size());
+
+  auto start = bench_clock::now();
+  list_reverse(&l);
+  double reverse_time = seconds_since(start);
+  start = bench_clock::now();
+  list_rotate(&l, size / 3);
+  double rotate_time = seconds_since(start);
+  start = bench_clock::now();
+  list_stable_partition(&l, bench_is_odd, nullptr);
+  double partition_time = seconds_since(start);
+  start = bench_clock::now();
+  list_shuffle(&l, 38);
+  double shuffle_time = seconds_since(start);
+  list_destroy(&l);
+
+  std::printf("%zu elements\n", size);
+  std::printf("%-12s %10s %12s\n", "operation", "time (s)", "ns/node");
+  std::printf("%-12s %10.4f %12.2f\n", "reverse", reverse_time, reverse_time * 1e9 / size);
+  std::printf("%-12s %10.4f %12.2f\n", "rotate", rotate_time, rotate_time * 1e9 / size);
+  std::printf("%-12s %10.4f %12.2f\n", "partition", partition_time, partition_time * 1e9 / size);
+  std::printf("%-12s %10.4f %12.2f\n", "shuffle", shuffle_time, shuffle_time * 1e9 / size);
+}
+
+/*
+ * cache: threads building short lists with list_push_back and destroying
+ * them, malloc vs list_node_cache. In the remote phase each thread destroys
+ * the lists built by another one.
+ */
+
+struct cache_phases {
+  double build;
+  double destroy;
+};
+
+static cache_phases bench_cache_run(const struct list_allocator *allocator, std::size_t threads, std::size_t lists, std::size_t length) {
+  std::vector<std::vector<struct list>> built(threads, std::vector<struct list>(lists));
+  auto run = [&](auto &&work) {
+    std::vector<std::thread> workers;
+    auto start = bench_clock::now();
+    for (std::size_t t = 0; t < threads; ++t) {
+      workers.emplace_back(work, t);
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    return seconds_since(start);
+  };
+
+  cache_phases phases;
+  phases.build = run([&](std::size_t t) {
+    for (struct list &l : built[t]) {
+      list_create_with_allocator(&l, allocator);
+      for (std::size_t i = 0; i < length; ++i) {
+        list_push_back(&l, int(i));
+      }
+    }
+  });
+  phases.destroy = run([&](std::size_t t) {
+    for (struct list &l : built[(t + 1) % threads]) {
+      list_destroy(&l);
+    }
+  });
+  return phases;
+}
+
+static void bench_cache(int argc, char *argv[]) {
+  std::size_t lists = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 20000;
+  std::size_t length = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 32;
+
+  std::printf("%zu lists of %zu nodes per thread\n", lists, length);
+  std::printf("%-8s %8s %16s %16s\n", "alloc", "threads", "build Mnodes/s", "remote Mnodes/s");
+  for (std::size_t threads = 1; threads <= 8; threads *= 2) {
+    double nodes = double(threads * lists * length);
+    cache_phases plain = bench_cache_run(nullptr, threads, lists, length);
+    std::printf("%-8s %8zu %16.2f %16.2f\n", "malloc", threads, nodes / plain.build / 1e6, nodes / plain.destroy / 1e6);
+
+    struct list_node_cache *cache = list_node_cache_create(0, 0);
+    cache_phases cached = bench_cache_run(list_node_cache_allocator(cache), threads, lists, length);
+    std::printf("%-8s %8zu %16.2f %16.2f\n", "cache", threads, nodes / cached.build / 1e6, nodes / cached.destroy / 1e6);
+    list_node_cache_destroy(cache);
+  }
+}
+
+/*
+ * rcu: searches per second from reader threads while one writer replaces
+ * a value every write_period_us, struct list under a mutex or a
+ * shared_mutex vs rcu_list
+ */
+
+template<typename Read, typename Write>
+static double bench_rcu_run(std::size_t readers, double duration, unsigned write_period_us, Read read, Write write) {
+  std::atomic<bool> done(false);
+  std::atomic<std::size_t> reads(0);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < readers; ++t) {
+    threads.emplace_back([&, t]() {
+      std::size_t count = 0;
+      unsigned key = unsigned(t);
+      while (!done.load(std::memory_order_relaxed)) {
+        read(int(key % 1000));
+        key = key * 1103515245u + 12345u;
+        ++count;
+      }
+      reads += count;
+    });
+  }
+  threads.emplace_back([&]() {
+    std::size_t i = 0;
+    while (!done.load(std::memory_order_relaxed)) {
+      write(i++ % 1000);
+      std::this_thread::sleep_for(std::chrono::microseconds(write_period_us));
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return reads.load() / duration;
+}
+
+static void bench_rcu(int argc, char *argv[]) {
+  double duration = argc > 0 ? std::strtod(argv[0], nullptr) : 0.5;
+  unsigned write_period_us = argc > 1 ? unsigned(std::strtoul(argv[1], nullptr, 10)) : 100;
+  const int size = 1000;
+
+  struct list l;
+  list_create(&l);
+  struct rcu_list *rcu = rcu_list_create();
+  for (int i = 0; i < size; ++i) {
+    list_push_back(&l, i);
+    rcu_list_push_back(rcu, i);
+  }
+
+  std::printf("%d elements, one write every %u us, %.1f s per run\n", size, write_period_us, duration);
+  std::printf("%-8s %14s %14s %14s\n", "readers", "mutex Mr/s", "rwlock Mr/s", "rcu Mr/s");
+  for (std::size_t readers = 1; readers <= 8; readers *= 2) {
+    std::mutex mutex;
+    double locked = bench_rcu_run(readers, duration, write_period_us,
+      [&](int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        volatile std::size_t index = list_search(&l, key);
+        (void)index;
+      },
+      [&](std::size_t index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        list_set(&l, index, int(index));
+      });
+
+    std::shared_mutex shared;
+    double shared_locked = bench_rcu_run(readers, duration, write_period_us,
+      [&](int key) {
+        std::shared_lock<std::shared_mutex> lock(shared);
+        volatile std::size_t index = list_search(&l, key);
+        (void)index;
+      },
+      [&](std::size_t index) {
+        std::unique_lock<std::shared_mutex> lock(shared);
+        list_set(&l, index, int(index));
+      });
+
+    double lock_free = bench_rcu_run(readers, duration, write_period_us,
+      [&](int key) {
+        volatile std::size_t index = rcu_list_search(rcu, key);
+        (void)index;
+      },
+      [&](std::size_t index) {
+        rcu_list_set(rcu, index, int(index));
+      });
+
+    std::printf("%-8zu %14.3f %14.3f %14.3f\n", readers, locked / 1e6, shared_locked / 1e6, lock_free / 1e6);
+  }
+
+  rcu_list_destroy(rcu);
+  list_destroy(&l);
+}
+
+/*
+ * fingerprint: list comparison, size and min/max with and without a
+ * maintained fingerprint
+ */
+
+static void bench_fingerprint(int argc, char *argv[]) {
+  std::size_t size = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 100000;
+  std::size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+
+  std::mt19937 gen(42);
+  std::vector<int> values(size);
+  for (auto &value : values) {
+    value = int(gen());
+  }
+  std::vector<int> changed = values;
+  if (!changed.empty()) {
+    changed.back() ^= 1;
+  }
+
+  std::printf("%zu elements, %zu rounds\n", size, rounds);
+  std::printf("%-12s %14s %14s %14s %14s\n", "list", "equal/s", "differ/s", "size/s", "min_max/s");
+  // build both sets before timing so neither reuses the other's freed nodes
+  struct list lists[2][3];
+  for (auto &set : lists) {
+    list_create_from(&set[0], values.data(), values.size());
+    list_create_from(&set[1], values.data(), values.size());
+    list_create_from(&set[2], changed.data(), changed.size());
+  }
+  for (struct list &l : lists[1]) {
+    list_fingerprint_attach(&l);
+  }
+
+  for (auto &set : lists) {
+    struct list &l = set[0];
+    std::size_t checksum = 0;
+    auto start = bench_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i) {
+      checksum += list_equals_list(&l, &set[1]);
+    }
+    double equal_time = seconds_since(start);
+    start = bench_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i) {
+      checksum += list_equals_list(&l, &set[2]);
+    }
+    double differ_time = seconds_since(start);
+    start = bench_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i) {
+      checksum += list_size(&l);
+    }
+    double size_time = seconds_since(start);
+    start = bench_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i) {
+      int min = 0;
+      int max = 0;
+      list_min_max(&l, &min, &max);
+      checksum += std::size_t(max) - std::size_t(min);
+    }
+    double min_max_time = seconds_since(start);
+
+    std::printf("%-12s %14.0f %14.0f %14.0f %14.0f (checksum %zu)\n", l.fingerprint != nullptr ? "fingerprint" : "plain",
+        rounds / equal_time, rounds / differ_time, rounds / size_time, rounds / min_max_time, checksum);
+  }
+
+  for (auto &set : lists) {
+    for (struct list &l : set) {
+      list_destroy(&l);
+    }
+  }
+}
+
+/*
+ * lru: read-through caching of Zipfian traces, a struct list used as an
+ * LRU queue (move to front by search and remove) vs list_cache
+ */
+
+static std::vector<int> zipf_trace(std::size_t keys, std::size_t length, double skew, std::size_t scan_every, std::mt19937 &gen) {
+  std::vector<double> cdf(keys);
+  double sum = 0;
+  for (std::size_t i = 0; i < keys; ++i) {
+    sum += 1.0 / std::pow(double(i + 1), skew);
+    cdf[i] = sum;
+  }
+  std::uniform_real_distribution<double> distribution(0, sum);
+  std::vector<int> trace(length);
+  int scanned = int(keys);
+  for (std::size_t i = 0; i < length; ++i) {
+    if (scan_every != 0 && i % scan_every == 0) {
+      // a key that is never accessed again
+      trace[i] = scanned++;
+    } else {
+      trace[i] = int(std::lower_bound(cdf.begin(), cdf.end(), distribution(gen)) - cdf.begin());
+    }
+  }
+  return trace;
+}
+
+static double replay_list(const std::vector<int> &trace, std::size_t capacity, std::size_t &hits) {
+  struct list keys;
+  list_create(&keys);
+  std::size_t size = 0;
+  hits = 0;
+  auto start = bench_clock::now();
+  for (int key : trace) {
+    std::size_t index = list_search(&keys, key);
+    if (index != size) {
+      ++hits;
+      list_remove(&keys, index);
+    } else if (size == capacity) {
+      list_pop_back(&keys);
+    } else {
+      ++size;
+    }
+    list_push_front(&keys, key);
+  }
+  double time = seconds_since(start);
+  list_destroy(&keys);
+  return time;
+}
+
+static double replay_cache(const std::vector<int> &trace, std::size_t capacity, list_cache_policy policy, std::size_t &hits) {
+  struct list_cache *cache = list_cache_create(capacity, LIST_CACHE_ENTRIES, policy);
+  auto start = bench_clock::now();
+  for (int key : trace) {
+    if (!list_cache_get(cache, key, nullptr)) {
+      list_cache_put(cache, key, key, 0);
+    }
+  }
+  double time = seconds_since(start);
+  hits = list_cache_stats(cache).hits;
+  list_cache_destroy(cache);
+  return time;
+}
+
+static void bench_lru(int argc, char *argv[]) {
+  std::size_t capacity = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 1000;
+  std::size_t length = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+  std::size_t keys = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+  std::mt19937 gen(43);
+  const struct {
+    const char *name;
+    std::vector<int> trace;
+  } traces[] = {
+    { "zipf", zipf_trace(keys, length, 0.99, 0, gen) },
+    { "zipf+scan", zipf_trace(keys, length, 0.99, 4, gen) },
+  };
+
+  std::printf("%zu entries, %zu accesses over %zu keys\n", capacity, length, keys);
+  std::printf("%-10s %-10s %10s %14s\n", "trace", "cache", "hit ratio", "accesses/s");
+  for (const auto &trace : traces) {
+    std::size_t hits = 0;
+    double time = replay_list(trace.trace, capacity, hits);
+    std::printf("%-10s %-10s %10.3f %14.0f\n", trace.name, "list", double(hits) / length, length / time);
+    time = replay_cache(trace.trace, capacity, LIST_CACHE_LRU, hits);
+    std::printf("%-10s %-10s %10.3f %14.0f\n", trace.name, "lru", double(hits) / length, length / time);
+    time = replay_cache(trace.trace, capacity, LIST_CACHE_2Q, hits);
+    std::printf("%-10s %-10s %10.3f %14.0f\n", trace.name, "2q", double(hits) / length, length / time);
+  }
+}
+
+/*
+ * adaptive: struct list vs adaptive_list on indexed, splicing and phased
+ * workloads, and the costs the default tuning is derived from
+ */
+
+static void bench_adaptive(int argc, char *argv[]) {
+  std::size_t size = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 10000;
+  std::size_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+
+  std::mt19937 gen(44);
+  std::vector<int> values(size);
+  for (auto &value : values) {
+    value = int(gen());
+  }
+
+  // calibration: a node visit and a memmove'd value, in array reads
+  {
+    struct list l;
+    list_create_from(&l, values.data(), values.size());
+    std::size_t rounds = 100;
+    std::size_t checksum = 0;
+    auto start = bench_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i) {
+      checksum += std::size_t(list_get(&l, size - 1));
+    }
+    double node = seconds_since(start) / double(rounds * size);
+    start = bench_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i) {
+      for (int value : values) {
+        checksum += std::size_t(value);
+      }
+    }
+    double read = seconds_since(start) / double(rounds * size);
+    std::vector<int> moved(size + 1);
+    start = bench_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i) {
+      std::memmove(&moved[i % 2], &moved[1 - i % 2], size * sizeof(int));
+    }
+    double move = seconds_since(start) / double(rounds * size);
+    std::printf("node visit %.2f ns, array read %.2f ns, moved value %.3f ns (checksum %zu)\n", node * 1e9, read * 1e9, move * 1e9, checksum + std::size_t(moved[0]));
+    std::printf("node_cost %.1f, move_divisor %.1f\n", node / read, read / move);
+    list_destroy(&l);
+  }
+
+  enum workload { INDEXED, SPLICES, ENDS, PHASES };
+  static const char *const names[] = { "indexed", "splices", "ends", "phases" };
+  auto run = [&](auto &&get, auto &&set, auto &&insert, auto &&remove, workload kind) {
+    std::mt19937 gen(45);
+    std::size_t checksum = 0;
+    std::size_t current = size;
+    for (std::size_t i = 0; i < operations; ++i) {
+      workload phase = (kind == PHASES) ? ((i / 2000) % 2 == 0 ? INDEXED : ENDS) : kind;
+      std::size_t index = gen() % current;
+      switch (phase) {
+      case INDEXED:
+        if (i % 2 == 0) {
+          checksum += std::size_t(get(index));
+        } else {
+          set(index, int(i));
+        }
+        break;
+      case SPLICES:
+        if (i % 2 == 0) {
+          insert(index, int(i));
+          ++current;
+        } else {
+          remove(index);
+          --current;
+        }
+        break;
+      default:
+        if (i % 2 == 0) {
+          insert(0, int(i));
+          ++current;
+        } else {
+          remove(current - 1);
+          --current;
+        }
+        break;
+      }
+    }
+    return checksum;
+  };
+
+  std::printf("%zu elements, %zu operations\n", size, operations);
+  std::printf("%-10s %12s %12s %10s %10s\n", "workload", "list (s)", "adaptive (s)", "to array", "to linked");
+  for (workload kind : { INDEXED, SPLICES, ENDS, PHASES }) {
+    struct list l;
+    list_create_from(&l, values.data(), values.size());
+    auto start = bench_clock::now();
+    std::size_t checksum = run(
+      [&](std::size_t index) { return list_get(&l, index); },
+      [&](std::size_t index, int value) { list_set(&l, index, value); },
+      [&](std::size_t index, int value) { list_insert(&l, value, index); },
+      [&](std::size_t index) { list_remove(&l, index); },
+      kind);
+    double list_time = seconds_since(start);
+    list_destroy(&l);
+
+    struct adaptive_list a;
+    adaptive_list_create_from(&a, values.data(), values.size());
+    start = bench_clock::now();
+    checksum -= run(
+      [&](std::size_t index) { return adaptive_list_get(&a, index); },
+      [&](std::size_t index, int value) { adaptive_list_set(&a, index, value); },
+      [&](std::size_t index, int value) { adaptive_list_insert(&a, value, index); },
+      [&](std::size_t index) { adaptive_list_remove(&a, index); },
+      kind);
+    double adaptive_time = seconds_since(start);
+    const struct adaptive_list_stats *stats = adaptive_list_stats(&a);
+    std::printf("%-10s %12.4f %12.4f %10zu %10zu%s\n", names[kind], list_time, adaptive_time, stats->to_array, stats->to_linked,
+        checksum == 0 ? "" : " (checksum mismatch)");
+    adaptive_list_destroy(&a);
+  }
+}
+
+struct bench_entry {
+  const char *name;
+  void (*run)(int argc, char *argv[]);
+};
+
+static const bench_entry benches[] = {
+  { "queue", bench_queue },
+  { "arena", bench_arena },
+  { "parallel", bench_parallel },
+  { "small", bench_small },
+  { "index", bench_index },
+  { "select", bench_select },
+  { "reorder", bench_reorder },
+  { "cache", bench_cache },
+  { "rcu", bench_rcu },
+  { "fingerprint", bench_fingerprint },
+  { "lru", bench_lru },
+  { "adaptive", bench_adaptive },
+};
+
+int main(int argc, char *argv[]) {
+  for (const bench_entry &entry : benches) {
+    if (argc < 2 || std::strcmp(argv[1], entry.name) == 0) {
+      entry.run(argc > 2 ? argc - 2 : 0, argv + 2);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,213 @@
+#ifndef CONSTEXPR_LIST_HPP
+#define CONSTEXPR_LIST_HPP
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "linkedList.h"
+
+/*
+ * Linked list usable in constant expressions. The nodes live in arrays and
+ * are linked by index, so construction, merge sort, search and is_sorted all
+ * run at compile time. static_list then lays the result out as read-only
+ * list_node objects, readable with the const functions of linkedList.h:
+ *
+ *   static constexpr int raw[] = { 5, 3, 9 };
+ *   static constexpr auto table = make_constexpr_list(raw).merge_sorted();
+ *   list_get(&static_list<table>::list, 0) // 3, and no work at startup
+ */
+template<std::size_t N>
+class constexpr_list {
+public:
+  static constexpr std::size_t npos = N;
+
+  constexpr constexpr_list() : data(), next(), first(npos), count(0) {}
+
+  constexpr explicit constexpr_list(const int (&values)[N == 0 ? 1 : N]) : data(), next(), first(N == 0 ? npos : 0), count(N) {
+    for (std::size_t i = 0; i < N; ++i) {
+      data[i] = values[i];
+      next[i] = i + 1;
+    }
+  }
+
+  constexpr std::size_t size() const { return count; }
+  constexpr bool empty() const { return count == 0; }
+
+  /*
+   * Get the element at the specified index or 0 if the index is not valid
+   */
+  constexpr int get(std::size_t index) const {
+    std::size_t curr = first;
+    for (std::size_t i = 0; i < index && curr != npos; ++i) {
+      curr = next[curr];
+    }
+    return curr == npos ? 0 : data[curr];
+  }
+
+  /*
+   * Search for an element and return its index or the size of the list if not present
+   */
+  constexpr std::size_t search(int value) const {
+    std::size_t i = 0;
+    for (std::size_t curr = first; curr != npos; curr = next[curr]) {
+      if (data[curr] == value) {
+        return i;
+      }
+      ++i;
+    }
+    return count;
+  }
+
+  constexpr bool is_sorted() const {
+    if (first == npos) {
+      return true;
+    }
+    for (std::size_t curr = first; next[curr] != npos; curr = next[curr]) {
+      if (data[curr] > data[next[curr]]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*
+   * Add an element at the beginning, the list holds at most N elements
+   */
+  constexpr void push_front(int value) {
+    // no element is ever removed, so the slots in use are 0 to count - 1
+    std::size_t slot = count;
+    data[slot] = value;
+    next[slot] = first;
+    first = slot;
+    ++count;
+  }
+
+  /*
+   * Stable bottom-up merge sort relinking the indices
+   */
+  constexpr void merge_sort() {
+    for (std::size_t width = 1; width < count; width *= 2) {
+      std::size_t rest = first;
+      std::size_t tail = npos;
+      while (rest != npos) {
+        std::size_t lhs = rest;
+        std::size_t rhs = cut(lhs, width);
+        rest = cut(rhs, width);
+        tail = merge(tail, lhs, rhs);
+      }
+    }
+  }
+
+  constexpr constexpr_list merge_sorted() const {
+    constexpr_list copy = *this;
+    copy.merge_sort();
+    return copy;
+  }
+
+  /*
+   * Values in list order
+   */
+  constexpr std::array<int, N> values() const {
+    std::array<int, N> out = {};
+    std::size_t i = 0;
+    for (std::size_t curr = first; curr != npos; curr = next[curr]) {
+      out[i++] = data[curr];
+    }
+    return out;
+  }
+
+private:
+  // link the merge of two sorted chains after tail (or as first), return the new tail
+  constexpr std::size_t merge(std::size_t tail, std::size_t lhs, std::size_t rhs) {
+    while (lhs != npos || rhs != npos) {
+      std::size_t taken = lhs;
+      if (rhs != npos && (lhs == npos || data[rhs] < data[lhs])) {
+        taken = rhs;
+        rhs = next[rhs];
+      } else {
+        lhs = next[lhs];
+      }
+      if (tail == npos) {
+        first = taken;
+      } else {
+        next[tail] = taken;
+      }
+      tail = taken;
+    }
+    next[tail] = npos;
+    return tail;
+  }
+
+  // cut the chain after width elements, return the rest
+  constexpr std::size_t cut(std::size_t start, std::size_t width) {
+    if (start == npos) {
+      return npos;
+    }
+    std::size_t curr = start;
+    for (std::size_t i = 1; i < width && next[curr] != npos; ++i) {
+      curr = next[curr];
+    }
+    std::size_t rest = next[curr];
+    next[curr] = npos;
+    return rest;
+  }
+
+  int data[N == 0 ? 1 : N];
+  std::size_t next[N == 0 ? 1 : N];
+  std::size_t first;
+  std::size_t count;
+};
+
+template<std::size_t N>
+constexpr constexpr_list<N> make_constexpr_list(const int (&values)[N]) {
+  return constexpr_list<N>(values);
+}
+
+namespace constexpr_list_detail {
+
+template<const auto &List, typename Indices>
+struct static_nodes;
+
+template<const auto &List>
+struct static_nodes<List, std::index_sequence<>> {
+  static constexpr struct list_node *first = nullptr;
+};
+
+template<const auto &List, std::size_t... I>
+struct static_nodes<List, std::index_sequence<I...>> {
+  static constexpr auto values = List.values();
+
+  static const struct list_node nodes[sizeof...(I)];
+
+  // const_cast is fine: nothing ever writes through these pointers
+  static constexpr struct list_node *first = const_cast<struct list_node *>(&nodes[0]);
+};
+
+// defined out of the class so that the initializer can refer to the array itself
+template<const auto &List, std::size_t... I>
+const struct list_node static_nodes<List, std::index_sequence<I...>>::nodes[sizeof...(I)] = {
+  { values[I], I + 1 < sizeof...(I) ? const_cast<struct list_node *>(&nodes[I + 1]) : nullptr }...
+};
+
+// only first is set by name, the fields added to struct list later are value initialized
+constexpr struct list make_static_list(struct list_node *first) {
+  struct list list{};
+  list.first = first;
+  return list;
+}
+
+} // namespace constexpr_list_detail
+
+/*
+ * Read-only struct list built at compile time from a constexpr_list with
+ * static storage. The nodes are in list order, next to each other.
+ */
+template<const auto &List>
+struct static_list {
+  using storage = constexpr_list_detail::static_nodes<List, std::make_index_sequence<List.size()>>;
+
+  static constexpr struct list list = constexpr_list_detail::make_static_list(storage::first);
+};
+
+#endif // CONSTEXPR_LIST_HPP
@@ -0,0 +1,322 @@
+/*
+ * Differential fuzz target: random operation sequences are applied to a
+ * struct list and to a std::vector reference model, which must always agree.
+ *
+ * libFuzzer: configure with -DLIST_FUZZ_LIBFUZZER=ON and clang
+ * AFL:       fuzz @@ (or the input on stdin)
+ * Smoke run: fuzz --random <iterations> [seed]
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "linkedList.h"
+#include "nodeArena.h"
+#include "listIndex.h"
+#include "listFingerprint.h"
+
+#define FUZZ_MAX_SIZE 256
+
+#define FUZZ_CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      std::abort(); \
+    } \
+  } while (0)
+
+namespace {
+
+class fuzz_input {
+public:
+  fuzz_input(const std::uint8_t *data, std::size_t size) : data(data), size(size) {}
+
+  bool done() const { return size == 0; }
+
+  std::uint8_t byte() {
+    if (size == 0) {
+      return 0;
+    }
+    --size;
+    return *data++;
+  }
+
+  int value() {
+    // small values so that duplicates and searches hit often
+    return static_cast<int>(static_cast<std::int8_t>(byte())) / 4;
+  }
+
+  std::size_t index(std::size_t bound) {
+    std::size_t raw = byte() | (static_cast<std::size_t>(byte()) << 8);
+    return bound == 0 ? 0 : raw % bound;
+  }
+
+private:
+  const std::uint8_t *data;
+  std::size_t size;
+};
+
+enum fuzz_op {
+  OP_PUSH_FRONT,
+  OP_POP_FRONT,
+  OP_PUSH_BACK,
+  OP_POP_BACK,
+  OP_INSERT,
+  OP_REMOVE,
+  OP_GET,
+  OP_SET,
+  OP_SEARCH,
+  OP_IS_SORTED,
+  OP_MERGE_SORT,
+  OP_SPLIT_MERGE,
+  OP_CREATE_FROM,
+  OP_CLEAR,
+  OP_EXTRACT_INSERT,
+  OP_COUNT
+};
+
+void check_model(const struct list *l, const std::vector<int> &model) {
+  FUZZ_CHECK(list_size(l) == model.size());
+  FUZZ_CHECK(list_empty(l) == model.empty());
+  FUZZ_CHECK(list_equals(l, model.data(), model.size()));
+}
+
+void run(const std::uint8_t *data, std::size_t size) {
+  fuzz_input in(data, size);
+
+  // the first byte chooses the node allocator and whether the list is indexed
+  // and fingerprinted
+  std::uint8_t config = in.byte();
+  bool use_arena = config & 1;
+  bool use_index = config & 2;
+  bool use_fingerprint = config & 4;
+  struct list_node_arena arena;
+  if (use_arena) {
+    list_node_arena_create(&arena, 0, LIST_ARENA_TRANSPARENT_HUGE_PAGES, -1);
+  }
+  const struct list_allocator *allocator = use_arena ? &arena.allocator : nullptr;
+
+  struct list l;
+  list_create_with_allocator(&l, allocator);
+  if (use_index) {
+    list_index_attach(&l);
+  }
+  if (use_fingerprint) {
+    list_fingerprint_attach(&l);
+  }
+  std::vector<int> model;
+
+  while (!in.done()) {
+    switch (in.byte() % OP_COUNT) {
+    case OP_PUSH_FRONT:
+      if (model.size() < FUZZ_MAX_SIZE) {
+        int value = in.value();
+        list_push_front(&l, value);
+        model.insert(model.begin(), value);
+      }
+      break;
+
+    case OP_POP_FRONT:
+      if (!model.empty()) {
+        list_pop_front(&l);
+        model.erase(model.begin());
+      }
+      break;
+
+    case OP_PUSH_BACK:
+      if (model.size() < FUZZ_MAX_SIZE) {
+        int value = in.value();
+        list_push_back(&l, value);
+        model.push_back(value);
+      }
+      break;
+
+    case OP_POP_BACK:
+      if (!model.empty()) {
+        list_pop_back(&l);
+        model.pop_back();
+      }
+      break;
+
+    case OP_INSERT:
+      if (model.size() < FUZZ_MAX_SIZE) {
+        int value = in.value();
+        std::size_t index = in.index(model.size() + 1);
+        list_insert(&l, value, index);
+        model.insert(model.begin() + index, value);
+      }
+      break;
+
+    case OP_REMOVE:
+      if (!model.empty()) {
+        std::size_t index = in.index(model.size());
+        list_remove(&l, index);
+        model.erase(model.begin() + index);
+      }
+      break;
+
+    case OP_GET: {
+      std::size_t index = in.index(model.size() + 2);
+      FUZZ_CHECK(list_get(&l, index) == (index < model.size() ? model[index] : 0));
+      break;
+    }
+
+    case OP_SET: {
+      int value = in.value();
+      std::size_t index = in.index(model.size() + 2);
+      list_set(&l, index, value);
+      if (index < model.size()) {
+        model[index] = value;
+      }
+      break;
+    }
+
+    case OP_SEARCH: {
+      int value = in.value();
+      auto it = std::find(model.begin(), model.end(), value);
+      FUZZ_CHECK(list_search(&l, value) == static_cast<std::size_t>(it - model.begin()));
+      break;
+    }
+
+    case OP_IS_SORTED:
+      FUZZ_CHECK(list_is_sorted(&l) == std::is_sorted(model.begin(), model.end()));
+      break;
+
+    case OP_MERGE_SORT:
+      list_merge_sort(&l);
+      std::sort(model.begin(), model.end());
+      break;
+
+    case OP_SPLIT_MERGE: {
+      struct list l1, l2;
+      list_create_with_allocator(&l1, allocator);
+      list_create_with_allocator(&l2, allocator);
+      list_split(&l, &l1, &l2);
+      FUZZ_CHECK(list_empty(&l));
+      FUZZ_CHECK(list_size(&l1) + list_size(&l2) == model.size());
+      list_merge_sort(&l1);
+      list_merge_sort(&l2);
+      list_merge(&l, &l1, &l2);
+      FUZZ_CHECK(list_empty(&l1));
+      FUZZ_CHECK(list_empty(&l2));
+      std::sort(model.begin(), model.end());
+      break;
+    }
+
+    case OP_CREATE_FROM: {
+      std::size_t count = in.byte() % 32;
+      std::vector<int> values;
+      for (std::size_t i = 0; i < count; ++i) {
+        values.push_back(in.value());
+      }
+      list_destroy(&l);
+      if (use_arena) {
+        // list_create_from always uses malloc
+        list_create_with_allocator(&l, allocator);
+        for (int value : values) {
+          list_push_back(&l, value);
+        }
+      } else {
+        list_create_from(&l, values.data(), values.size());
+      }
+      if (use_index) {
+        list_index_attach(&l);
+      }
+      if (use_fingerprint) {
+        list_fingerprint_attach(&l);
+      }
+      model = values;
+      break;
+    }
+
+    case OP_EXTRACT_INSERT:
+      if (!model.empty()) {
+        std::size_t from = in.index(model.size());
+        std::size_t to = in.index(model.size());
+        list_insert_node(&l, list_extract(&l, from), to);
+        int value = model[from];
+        model.erase(model.begin() + from);
+        model.insert(model.begin() + to, value);
+      }
+      break;
+
+    case OP_CLEAR:
+      list_destroy(&l);
+      list_create_with_allocator(&l, allocator);
+      if (use_index) {
+        list_index_attach(&l);
+      }
+      if (use_fingerprint) {
+        list_fingerprint_attach(&l);
+      }
+      model.clear();
+      break;
+    }
+
+    check_model(&l, model);
+    if (use_fingerprint) {
+      FUZZ_CHECK(list_fingerprint_hash(&l) == list_fingerprint_array(model.data(), model.size()));
+    }
+  }
+
+  list_destroy(&l);
+  if (use_arena) {
+    list_node_arena_destroy(&arena);
+  }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size) {
+  run(data, size);
+  return 0;
+}
+
+#ifndef LIST_FUZZ_LIBFUZZER
+
+static void run_stream(std::istream &stream) {
+  std::vector<std::uint8_t> input((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  run(input.data(), input.size());
+}
+
+int main(int argc, char *argv[]) {
+  if (argc >= 3 && std::strcmp(argv[1], "--random") == 0) {
+    long iterations = std::atol(argv[2]);
+    std::mt19937 gen(argc >= 4 ? std::atoi(argv[3]) : 0);
+    std::vector<std::uint8_t> input;
+    for (long i = 0; i < iterations; ++i) {
+      input.resize(gen() % 4096);
+      for (auto &byte : input) {
+        byte = static_cast<std::uint8_t>(gen());
+      }
+      run(input.data(), input.size());
+    }
+    return 0;
+  }
+
+  if (argc < 2) {
+    std::ios::sync_with_stdio(false);
+    run_stream(std::cin);
+    return 0;
+  }
+
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    if (!file) {
+      std::fprintf(stderr, "cannot open %s\n", argv[i]);
+      return 1;
+    }
+    run_stream(file);
+  }
+  return 0;
+}
+
+#endif
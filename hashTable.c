@@ -0,0 +1,131 @@
+#include "hashTable.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t table_home(const struct hash_table *self, int key) {
+  // Fibonacci hashing, the high bits are the well mixed ones
+  uint32_t hash = (uint32_t)key * 2654435769u;
+  return hash >> (32 - self->bits);
+}
+
+static size_t table_mask(const struct hash_table *self) {
+  return ((size_t)1 << self->bits) - 1;
+}
+
+static int table_key(const struct hash_table *self, const char *slot) {
+  int key;
+  memcpy(&key, slot + self->key_offset, sizeof(int));
+  return key;
+}
+
+static char *table_slot(const struct hash_table *self, size_t i) {
+  return self->slots + i * self->slot_size;
+}
+
+/*
+ * First empty slot from the home of a key
+ */
+static char *table_free_slot(const struct hash_table *self, int key) {
+  size_t mask = table_mask(self);
+  size_t i = table_home(self, key);
+  while(hash_table_occupied(table_slot(self, i))){
+    i = (i + 1) & mask;
+  }
+  return table_slot(self, i);
+}
+
+static bool table_resize(struct hash_table *self, unsigned bits) {
+  char *old = self->slots;
+  size_t old_capacity = hash_table_capacity(self);
+  char *slots = calloc((size_t)1 << bits, self->slot_size);
+  if(slots == NULL) return false;
+  self->slots = slots;
+  self->bits = bits;
+  for(size_t i=0; i<old_capacity; ++i){
+    char *slot = old + i * self->slot_size;
+    if(hash_table_occupied(slot)){
+      memcpy(table_free_slot(self, table_key(self, slot)), slot, self->slot_size);
+    }
+  }
+  free(old);
+  return true;
+}
+
+bool hash_table_create(struct hash_table *self, size_t slot_size, size_t key_offset, unsigned bits) {
+  self->slots = NULL;
+  self->slot_size = slot_size;
+  self->key_offset = key_offset;
+  self->bits = bits;
+  self->used = 0;
+  return table_resize(self, bits);
+}
+
+void hash_table_destroy(struct hash_table *self) {
+  free(self->slots);
+  self->slots = NULL;
+  self->used = 0;
+}
+
+void hash_table_clear(struct hash_table *self) {
+  memset(self->slots, 0, hash_table_capacity(self) * self->slot_size);
+  self->used = 0;
+}
+
+size_t hash_table_capacity(const struct hash_table *self) {
+  return self->slots == NULL ? 0 : (size_t)1 << self->bits;
+}
+
+void *hash_table_at(const struct hash_table *self, size_t i) {
+  return table_slot(self, i);
+}
+
+bool hash_table_occupied(const void *slot) {
+  void *pointer;
+  memcpy(&pointer, slot, sizeof(void *));
+  return pointer != NULL;
+}
+
+void *hash_table_find(const struct hash_table *self, int key) {
+  size_t mask = table_mask(self);
+  for(size_t i = table_home(self, key); ; i = (i + 1) & mask){
+    char *slot = table_slot(self, i);
+    if(!hash_table_occupied(slot)) return NULL;
+    if(table_key(self, slot) == key) return slot;
+  }
+}
+
+bool hash_table_reserve(struct hash_table *self) {
+  // load factor at most 3/4, keep at least one empty slot in any case
+  if(4 * (self->used + 1) > 3 * ((size_t)1 << self->bits)){
+    return table_resize(self, self->bits + 1) || self->used + 1 <= table_mask(self);
+  }
+  return true;
+}
+
+void *hash_table_insert(struct hash_table *self, int key) {
+  if(!hash_table_reserve(self)) return NULL;
+  ++self->used;
+  return table_free_slot(self, key);
+}
+
+void hash_table_remove(struct hash_table *self, void *slot) {
+  size_t mask = table_mask(self);
+  size_t hole = (size_t)((char *)slot - self->slots) / self->slot_size;
+  size_t i = hole;
+  for(;;){
+    i = (i + 1) & mask;
+    char *next = table_slot(self, i);
+    if(!hash_table_occupied(next)) break;
+    size_t home = table_home(self, table_key(self, next));
+    // next can fill the hole if its home is not in (hole, i]
+    bool stays = (hole <= i) ? (hole < home && home <= i) : (hole < home || home <= i);
+    if(!stays){
+      memcpy(table_slot(self, hole), next, self->slot_size);
+      hole = i;
+    }
+  }
+  memset(table_slot(self, hole), 0, self->slot_size);
+  --self->used;
+}
@@ -0,0 +1,83 @@
+#ifndef HASH_TABLE_H
+#define HASH_TABLE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Internal open addressing table of listIndex.c and listCache.c, keyed by
+ * an int. A slot is slot_size bytes, starts with a pointer which is NULL
+ * when the slot is empty and holds its key at key_offset. Linear probing
+ * from a Fibonacci hash, backward shift deletion, and a load factor of at
+ * most 3/4, with at least one empty slot in any case.
+ */
+struct hash_table {
+  char *slots;
+  size_t slot_size;
+  size_t key_offset;
+  unsigned bits;
+  size_t used;
+};
+
+/*
+ * Create an empty table of 2^bits slots, return false if the allocation failed
+ */
+bool hash_table_create(struct hash_table *self, size_t slot_size, size_t key_offset, unsigned bits);
+
+/*
+ * Free the slots
+ */
+void hash_table_destroy(struct hash_table *self);
+
+/*
+ * Empty all the slots, the capacity is kept
+ */
+void hash_table_clear(struct hash_table *self);
+
+/*
+ * Get the number of slots
+ */
+size_t hash_table_capacity(const struct hash_table *self);
+
+/*
+ * Get the slot at i, for a walk over the whole table
+ */
+void *hash_table_at(const struct hash_table *self, size_t i);
+
+/*
+ * Tell if a slot holds an entry
+ */
+bool hash_table_occupied(const void *slot);
+
+/*
+ * Look a key up, return NULL if not present
+ */
+void *hash_table_find(const struct hash_table *self, int key);
+
+/*
+ * Grow the table if needed so that one more key fits, return false if it
+ * cannot fit. The table is left as it is on failure.
+ */
+bool hash_table_reserve(struct hash_table *self);
+
+/*
+ * Get the empty slot a key not present goes to and count it, growing the
+ * table if needed, return NULL if it cannot fit. The caller fills the slot
+ * (pointer and key) before any other call.
+ */
+void *hash_table_insert(struct hash_table *self, int key);
+
+/*
+ * Empty a slot, the following ones may move back to fill the hole
+ */
+void hash_table_remove(struct hash_table *self, void *slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HASH_TABLE_H
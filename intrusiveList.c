@@ -0,0 +1,196 @@
+#include "intrusiveList.h"
+
+#include <assert.h>
+
+static struct ilist_link **ilist_link_at(struct ilist *self, size_t index) {
+  struct ilist_link **link = &self->first;
+  for(size_t i=0; i<index; ++i){
+    link = &(*link)->next;
+  }
+  return link;
+}
+
+/*
+ * Merge two sorted chains, elements of lhs come first on ties
+ */
+static struct ilist_link *ilist_merge_chains(struct ilist_link *lhs, struct ilist_link *rhs, ilist_compare compare, void *ctx) {
+  struct ilist_link *first = NULL;
+  struct ilist_link **link = &first;
+  while(lhs != NULL && rhs != NULL){
+    if(compare(rhs, lhs, ctx) < 0){
+      *link = rhs;
+      rhs = rhs->next;
+    }
+    else{
+      *link = lhs;
+      lhs = lhs->next;
+    }
+    link = &(*link)->next;
+  }
+  *link = (lhs != NULL) ? lhs : rhs;
+  return first;
+}
+
+void ilist_create(struct ilist *self) {
+  self->first = NULL;
+}
+
+bool ilist_empty(const struct ilist *self) {
+  return self->first == NULL;
+}
+
+size_t ilist_size(const struct ilist *self) {
+  size_t size = 0;
+  for(struct ilist_link *curr = self->first; curr != NULL; curr = curr->next){
+    ++size;
+  }
+  return size;
+}
+
+void ilist_push_front(struct ilist *self, struct ilist_link *link) {
+  link->next = self->first;
+  self->first = link;
+}
+
+struct ilist_link *ilist_pop_front(struct ilist *self) {
+  struct ilist_link *link = self->first;
+  if(link != NULL){
+    self->first = link->next;
+    link->next = NULL;
+  }
+  return link;
+}
+
+void ilist_push_back(struct ilist *self, struct ilist_link *link) {
+  struct ilist_link **last = &self->first;
+  while(*last != NULL){
+    last = &(*last)->next;
+  }
+  link->next = NULL;
+  *last = link;
+}
+
+struct ilist_link *ilist_pop_back(struct ilist *self) {
+  if(self->first == NULL) return NULL;
+  struct ilist_link **last = &self->first;
+  while((*last)->next != NULL){
+    last = &(*last)->next;
+  }
+  struct ilist_link *link = *last;
+  *last = NULL;
+  return link;
+}
+
+void ilist_insert(struct ilist *self, struct ilist_link *link, size_t index) {
+  struct ilist_link **at = ilist_link_at(self, index);
+  link->next = *at;
+  *at = link;
+}
+
+struct ilist_link *ilist_remove(struct ilist *self, size_t index) {
+  struct ilist_link **at = ilist_link_at(self, index);
+  struct ilist_link *link = *at;
+  assert(link != NULL);
+  *at = link->next;
+  link->next = NULL;
+  return link;
+}
+
+void ilist_insert_after(struct ilist *self, struct ilist_link *prev, struct ilist_link *link) {
+  struct ilist_link **at = (prev != NULL) ? &prev->next : &self->first;
+  link->next = *at;
+  *at = link;
+}
+
+struct ilist_link *ilist_remove_after(struct ilist *self, struct ilist_link *prev) {
+  struct ilist_link **at = (prev != NULL) ? &prev->next : &self->first;
+  struct ilist_link *link = *at;
+  assert(link != NULL);
+  *at = link->next;
+  link->next = NULL;
+  return link;
+}
+
+struct ilist_link *ilist_get(const struct ilist *self, size_t index) {
+  struct ilist_link *curr = self->first;
+  for(size_t i=0; i<index && curr != NULL; ++i){
+    curr = curr->next;
+  }
+  return curr;
+}
+
+size_t ilist_search(const struct ilist *self, ilist_predicate predicate, void *ctx) {
+  size_t i = 0;
+  for(struct ilist_link *curr = self->first; curr != NULL; curr = curr->next){
+    if(predicate(curr, ctx)) return i;
+    ++i;
+  }
+  return i;
+}
+
+bool ilist_is_sorted(const struct ilist *self, ilist_compare compare, void *ctx) {
+  if(self->first == NULL) return true;
+  for(struct ilist_link *curr = self->first; curr->next != NULL; curr = curr->next){
+    if(compare(curr, curr->next, ctx) > 0) return false;
+  }
+  return true;
+}
+
+void ilist_split(struct ilist *self, struct ilist *out1, struct ilist *out2) {
+  // the fast cursor walks two links for each link of the slow one
+  struct ilist_link **middle = &self->first;
+  struct ilist_link *fast = self->first;
+  while(fast != NULL && fast->next != NULL){
+    middle = &(*middle)->next;
+    fast = fast->next->next;
+  }
+  out2->first = *middle;
+  *middle = NULL;
+  out1->first = self->first;
+  self->first = NULL;
+}
+
+void ilist_merge(struct ilist *self, struct ilist *in1, struct ilist *in2, ilist_compare compare, void *ctx) {
+  self->first = ilist_merge_chains(in1->first, in2->first, compare, ctx);
+  in1->first = NULL;
+  in2->first = NULL;
+}
+
+void ilist_merge_sort(struct ilist *self, ilist_compare compare, void *ctx) {
+  // bottom-up: runs of width 1, 2, 4... are merged, no recursion nor allocation
+  size_t width = 1;
+  for(;;){
+    struct ilist_link *rest = self->first;
+    struct ilist_link *first = NULL;
+    struct ilist_link **link = &first;
+    size_t merges = 0;
+    while(rest != NULL){
+      struct ilist_link *lhs = rest;
+      struct ilist_link *curr = lhs;
+      for(size_t i=1; i<width && curr->next != NULL; ++i){
+        curr = curr->next;
+      }
+      struct ilist_link *rhs = curr->next;
+      curr->next = NULL;
+      curr = rhs;
+      for(size_t i=1; i<width && curr != NULL && curr->next != NULL; ++i){
+        curr = curr->next;
+      }
+      if(curr != NULL){
+        rest = curr->next;
+        curr->next = NULL;
+      }
+      else{
+        rest = NULL;
+      }
+      *link = ilist_merge_chains(lhs, rhs, compare, ctx);
+      while(*link != NULL){
+        link = &(*link)->next;
+      }
+      ++merges;
+    }
+    self->first = first;
+    if(merges <= 1) return;
+    width *= 2;
+  }
+}
@@ -0,0 +1,132 @@
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Link to embed in the caller's own struct. The list never allocates nor
+ * frees anything, the elements stay owned by the caller.
+ */
+struct ilist_link {
+  struct ilist_link *next;
+};
+
+struct ilist {
+  struct ilist_link *first;
+};
+
+/*
+ * Get the struct containing a link
+ */
+#define ilist_entry(link, type, member) \
+  ((type *)((char *)(link) - offsetof(type, member)))
+
+/*
+ * Compare two elements, return a negative, zero or positive value
+ */
+typedef int (*ilist_compare)(const struct ilist_link *lhs, const struct ilist_link *rhs, void *ctx);
+
+/*
+ * Tell if an element matches
+ */
+typedef bool (*ilist_predicate)(const struct ilist_link *link, void *ctx);
+
+/*
+ * Create an empty intrusive list
+ */
+void ilist_create(struct ilist *self);
+
+/*
+ * Tell if the intrusive list is empty
+ */
+bool ilist_empty(const struct ilist *self);
+
+/*
+ * Get the size of the intrusive list
+ */
+size_t ilist_size(const struct ilist *self);
+
+/*
+ * Link an element at the beginning
+ */
+void ilist_push_front(struct ilist *self, struct ilist_link *link);
+
+/*
+ * Unlink the element at the beginning and return it, or NULL if the list is empty
+ */
+struct ilist_link *ilist_pop_front(struct ilist *self);
+
+/*
+ * Link an element at the end
+ */
+void ilist_push_back(struct ilist *self, struct ilist_link *link);
+
+/*
+ * Unlink the element at the end and return it, or NULL if the list is empty
+ */
+struct ilist_link *ilist_pop_back(struct ilist *self);
+
+/*
+ * Link an element at index (preserving the order)
+ * index is valid or equals to the size of the list (insert at the end)
+ */
+void ilist_insert(struct ilist *self, struct ilist_link *link, size_t index);
+
+/*
+ * Unlink the element at index and return it (preserving the order)
+ * index is valid
+ */
+struct ilist_link *ilist_remove(struct ilist *self, size_t index);
+
+/*
+ * Link an element right after prev, or at the beginning if prev is NULL, in O(1)
+ * prev is linked in the list
+ */
+void ilist_insert_after(struct ilist *self, struct ilist_link *prev, struct ilist_link *link);
+
+/*
+ * Unlink the element right after prev, or at the beginning if prev is NULL, and return it, in O(1)
+ * The element exists
+ */
+struct ilist_link *ilist_remove_after(struct ilist *self, struct ilist_link *prev);
+
+/*
+ * Get the element at the specified index or NULL if the index is not valid
+ */
+struct ilist_link *ilist_get(const struct ilist *self, size_t index);
+
+/*
+ * Search for the first element matching the predicate and return its index or the size of the list if not present.
+ */
+size_t ilist_search(const struct ilist *self, ilist_predicate predicate, void *ctx);
+
+/*
+ * Tell if an intrusive list is sorted
+ */
+bool ilist_is_sorted(const struct ilist *self, ilist_compare compare, void *ctx);
+
+/*
+ * Split a list in two halves. At the end, self should be empty.
+ */
+void ilist_split(struct ilist *self, struct ilist *out1, struct ilist *out2);
+
+/*
+ * Merge two sorted lists in an empty list. At the end, in1 and in2 should be empty.
+ */
+void ilist_merge(struct ilist *self, struct ilist *in1, struct ilist *in2, ilist_compare compare, void *ctx);
+
+/*
+ * Sort an intrusive list with a stable merge sort, only relinking the elements
+ */
+void ilist_merge_sort(struct ilist *self, ilist_compare compare, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INTRUSIVE_LIST_H
@@ -0,0 +1,127 @@
+#ifndef INTRUSIVE_LIST_HPP
+#define INTRUSIVE_LIST_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "intrusiveList.h"
+
+/*
+ * Typed view of an ilist where the link is the member of T at HookOffset,
+ * given with offsetof: intrusive_list<task, offsetof(task, hook)>. T must
+ * be standard layout. The list does not own the elements.
+ */
+template<typename T, std::size_t HookOffset>
+class intrusive_list {
+  static_assert(std::is_standard_layout_v<T>, "the hook is found with offsetof");
+  static_assert(HookOffset + sizeof(ilist_link) <= sizeof(T), "the hook must be a member of T");
+
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    explicit iterator(ilist_link *link = nullptr) : link(link) {}
+
+    reference operator*() const { return *from_link(link); }
+    pointer operator->() const { return from_link(link); }
+
+    iterator &operator++() {
+      link = link->next;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator copy = *this;
+      link = link->next;
+      return copy;
+    }
+
+    bool operator==(const iterator &other) const { return link == other.link; }
+    bool operator!=(const iterator &other) const { return link != other.link; }
+
+  private:
+    ilist_link *link;
+  };
+
+  intrusive_list() { ilist_create(&raw); }
+
+  intrusive_list(const intrusive_list &) = delete;
+  intrusive_list &operator=(const intrusive_list &) = delete;
+
+  intrusive_list(intrusive_list &&other) noexcept : raw(other.raw) { ilist_create(&other.raw); }
+
+  intrusive_list &operator=(intrusive_list &&other) noexcept {
+    raw = other.raw;
+    ilist_create(&other.raw);
+    return *this;
+  }
+
+  bool empty() const { return ilist_empty(&raw); }
+  std::size_t size() const { return ilist_size(&raw); }
+
+  void push_front(T &value) { ilist_push_front(&raw, link_of(value)); }
+  void push_back(T &value) { ilist_push_back(&raw, link_of(value)); }
+  T *pop_front() { return from_link(ilist_pop_front(&raw)); }
+  T *pop_back() { return from_link(ilist_pop_back(&raw)); }
+
+  void insert(T &value, std::size_t index) { ilist_insert(&raw, link_of(value), index); }
+  T *remove(std::size_t index) { return from_link(ilist_remove(&raw, index)); }
+  T *get(std::size_t index) const { return from_link(ilist_get(&raw, index)); }
+
+  template<typename Predicate>
+  std::size_t search(Predicate predicate) const {
+    return ilist_search(&raw, &call_predicate<Predicate>, &predicate);
+  }
+
+  template<typename Less>
+  bool is_sorted(Less less) const {
+    return ilist_is_sorted(&raw, &call_compare<Less>, &less);
+  }
+
+  template<typename Less>
+  void merge_sort(Less less) {
+    ilist_merge_sort(&raw, &call_compare<Less>, &less);
+  }
+
+  iterator begin() const { return iterator(raw.first); }
+  iterator end() const { return iterator(); }
+
+  ilist *c_list() { return &raw; }
+
+  static ilist_link *link_of(T &value) {
+    return reinterpret_cast<ilist_link *>(reinterpret_cast<char *>(&value) + HookOffset);
+  }
+
+  static T *from_link(ilist_link *link) {
+    if (link == nullptr) {
+      return nullptr;
+    }
+    return reinterpret_cast<T *>(reinterpret_cast<char *>(link) - HookOffset);
+  }
+
+private:
+  template<typename Predicate>
+  static bool call_predicate(const ilist_link *link, void *ctx) {
+    return (*static_cast<Predicate *>(ctx))(*from_link(const_cast<ilist_link *>(link)));
+  }
+
+  template<typename Less>
+  static int call_compare(const ilist_link *lhs, const ilist_link *rhs, void *ctx) {
+    Less &less = *static_cast<Less *>(ctx);
+    const T &a = *from_link(const_cast<ilist_link *>(lhs));
+    const T &b = *from_link(const_cast<ilist_link *>(rhs));
+    if (less(a, b)) return -1;
+    if (less(b, a)) return 1;
+    return 0;
+  }
+
+  ilist raw;
+};
+
+#endif // INTRUSIVE_LIST_HPP
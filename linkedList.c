@@ -1,4 +1,6 @@
 #include "linkedList.h"
+#include "listIndex.h"
+#include "listFingerprint.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -7,6 +9,89 @@
 
 void list_create(struct list *self) {
   self -> first =  NULL;
+  self->allocator = NULL;
+  self->index = NULL;
+  self->fingerprint = NULL;
+}
+
+void list_create_with_allocator(struct list *self, const struct list_allocator *allocator) {
+  self->first = NULL;
+  self->allocator = allocator;
+  self->index = NULL;
+  self->fingerprint = NULL;
+}
+
+struct list_node *list_node_try_create(const struct list *self, int value) {
+  struct list_node *new;
+  if(self->allocator == NULL){
+    new = malloc(sizeof(struct list_node));
+  }
+  else{
+    new = self->allocator->allocate(self->allocator->ctx);
+  }
+  if(new == NULL) return NULL;
+  new->data = value;
+  new->next = NULL;
+  return new;
+}
+
+struct list_node *list_node_create(const struct list *self, int value) {
+  struct list_node *new = list_node_try_create(self, value);
+  if(new == NULL) abort(); // the push and insert functions cannot report it
+  return new;
+}
+
+void list_node_destroy(const struct list *self, struct list_node *node) {
+  if(self->allocator == NULL){
+    free(node);
+  }
+  else{
+    self->allocator->deallocate(self->allocator->ctx, node);
+  }
+}
+
+/*
+ * Keep the index and the fingerprint up to date, if attached
+ */
+
+static void notify_push_front(struct list *self, struct list_node *node) {
+  if(self->index != NULL) list_index_on_push_front(self->index, node);
+  if(self->fingerprint != NULL) list_fingerprint_on_push_front(self->fingerprint, node);
+}
+
+static void notify_pop_front(struct list *self, struct list_node *node) {
+  if(self->index != NULL) list_index_on_pop_front(self->index, node);
+  if(self->fingerprint != NULL) list_fingerprint_on_pop_front(self->fingerprint, node);
+}
+
+static void notify_pop_back(struct list *self, struct list_node *node) {
+  if(self->index != NULL) list_index_on_pop_back(self->index, node);
+  if(self->fingerprint != NULL) list_fingerprint_on_pop_back(self->fingerprint, node);
+}
+
+static void notify_insert(struct list *self, struct list_node *node, size_t index) {
+  if(self->index != NULL) list_index_on_insert(self->index, node, index);
+  if(self->fingerprint != NULL) list_fingerprint_on_insert(self->fingerprint, self->first, node, index);
+}
+
+static void notify_remove(struct list *self, struct list_node *node, size_t index) {
+  if(self->index != NULL) list_index_on_remove(self->index, node, index);
+  if(self->fingerprint != NULL) list_fingerprint_on_remove(self->fingerprint, self->first, node, index);
+}
+
+static void notify_set(struct list *self, struct list_node *node, size_t index, int old_value) {
+  if(self->index != NULL) list_index_on_set(self->index, node, index, old_value);
+  if(self->fingerprint != NULL) list_fingerprint_on_set(self->fingerprint, node, index, old_value);
+}
+
+void list_node_appended(struct list *self, struct list_node *node) {
+  if(self->index != NULL) list_index_on_push_back(self->index, node);
+  if(self->fingerprint != NULL) list_fingerprint_on_push_back(self->fingerprint, node);
+}
+
+void list_relinked(struct list *self) {
+  list_index_rebuild(self);
+  list_fingerprint_rebuild(self);
 }
 
 void list_print(struct list *self){
@@ -19,28 +104,33 @@ void list_print(struct list *self){
 }
 
 void list_create_from(struct list *self, const int *other, size_t size) {
-  self->first = malloc(sizeof(struct list_node));
+  list_create(self);
+  if(size == 0){
+    return;
+  }
+  self->first = list_node_create(self, other[0]);
   struct list_node *curr = self-> first;
-  curr->data = other[0];
   for(size_t i=1; i<size; ++i){
-   struct list_node *new = malloc(sizeof(struct list_node));
-   new->data = other[i];
+   struct list_node *new = list_node_create(self, other[i]);
    curr->next = new;
    curr = curr->next;
   }
   curr->next = NULL;
 }
 
-void node_destroy(struct list_node *curr){
-  if(curr->next == NULL){
-    free(curr);
-    return;
+static void node_destroy(const struct list *self, struct list_node *curr){
+  while(curr != NULL){
+    struct list_node *next = curr->next;
+    list_node_destroy(self, curr);
+    curr = next;
   }
-  node_destroy(curr->next);
 }
 
 void list_destroy(struct list *self) {
-  if(list_empty(self) != true)node_destroy(self->first);
+  if(list_empty(self) != true)node_destroy(self, self->first);
+  self->first = NULL;
+  list_index_detach(self);
+  list_fingerprint_detach(self);
 }
 
 bool list_empty(const struct list *self) {
@@ -48,6 +138,8 @@ bool list_empty(const struct list *self) {
 }
 
 size_t list_size(const struct list *self) {
+  size_t cached;
+  if(list_fingerprint_size(self, &cached)) return cached;
   struct list_node *curr = self->first;
   size_t size = 0;
   while (curr != NULL) {
@@ -59,6 +151,8 @@ size_t list_size(const struct list *self) {
 
 bool list_equals(const struct list *self, const int *data, size_t size){
   if(list_empty(self) && size!=0) return false;
+  size_t cached;
+  if(list_fingerprint_size(self, &cached) && cached != size) return false;
   if(list_size(self)!=size)return false;
   struct list_node *curr = self->first;
   for(size_t i=0; i<size; ++i){
@@ -69,22 +163,23 @@ bool list_equals(const struct list *self, const int *data, size_t size){
 }
 
 void list_push_front(struct list *self, int value) {
-  struct list_node *new = malloc(sizeof(struct list_node));
-  new->data = value;
+  struct list_node *new = list_node_create(self, value);
   new->next = self->first;
   self->first = new;
+  notify_push_front(self, new);
 }
 
 void list_pop_front(struct list *self) {
-  if(list_size(self)>0){
-    self->first = self->first->next;
+  if(self->first != NULL){
+    struct list_node *old = self->first;
+    self->first = old->next;
+    notify_pop_front(self, old);
+    list_node_destroy(self, old);
   }
 }
 
 void list_push_back(struct list *self, int value) {
-  struct list_node *new = malloc(sizeof(struct list_node));
-  new->data = value;
-  new->next = NULL;
+  struct list_node *new = list_node_create(self, value);
   if(self->first == NULL){
     self->first = new;
   }
@@ -95,13 +190,16 @@ void list_push_back(struct list *self, int value) {
     }
     curr->next = new;
   }
+  list_node_appended(self, new);
 }
 
 void list_pop_back(struct list *self) {
   struct list_node *curr =self->first;
+  if(curr == NULL) return;
   if(curr->next == NULL){
-    free(curr);
     self->first = NULL;
+    notify_pop_back(self, curr);
+    list_node_destroy(self, curr);
   }
   else{
     struct list_node *theNext =curr->next;
@@ -109,8 +207,9 @@ void list_pop_back(struct list *self) {
       theNext = theNext->next;
       curr = curr->next;
     }
-    free(theNext);
     curr->next = NULL;
+    notify_pop_back(self, theNext);
+    list_node_destroy(self, theNext);
   }
 }
 
@@ -119,13 +218,13 @@ void list_insert(struct list *self, int value, size_t index) {
   if(index == 0)list_push_front(self,value);
   else{
     struct list_node *curr = self->first;
-    struct list_node *new = malloc(sizeof(struct list_node));
-    new->data = value;
+    struct list_node *new = list_node_create(self, value);
     for(size_t i=0; i<index-1;++i){
       curr = curr->next;
     }
     new->next = curr->next;
     curr->next = new;
+    notify_insert(self, new, index);
   }
 }
 
@@ -133,17 +232,39 @@ void list_insert(struct list *self, int value, size_t index) {
 void list_remove(struct list *self, size_t index) {
   if(index == 0)list_pop_front(self);
   else{
-    struct list_node *buffer = malloc(sizeof(struct list_node));
     struct list_node *curr = self->first;
     for(size_t i=0; i<index-1;++i){
       curr = curr->next;
     }
-    buffer = curr->next;
+    struct list_node *buffer = curr->next;
     curr->next = buffer->next;
-    free(buffer);
+    notify_remove(self, buffer, index);
+    list_node_destroy(self, buffer);
   }
 }
 
+struct list_node *list_extract(struct list *self, size_t index) {
+  struct list_node **link = &self->first;
+  for(size_t i=0; i<index; ++i){
+    link = &(*link)->next;
+  }
+  struct list_node *node = *link;
+  *link = node->next;
+  notify_remove(self, node, index);
+  node->next = NULL;
+  return node;
+}
+
+void list_insert_node(struct list *self, struct list_node *node, size_t index) {
+  struct list_node **link = &self->first;
+  for(size_t i=0; i<index; ++i){
+    link = &(*link)->next;
+  }
+  node->next = *link;
+  *link = node;
+  notify_insert(self, node, index);
+}
+
 int list_get(const struct list *self, size_t index) {
   if(index<list_size(self)){
     struct list_node *curr = self->first;
@@ -161,17 +282,30 @@ void list_set(struct list *self, size_t index, int value) {
     for(size_t i=0; i<index; ++i){
       curr=curr->next;
     }
-    curr->data = value;
+    list_node_set(self, curr, index, value);
   }
 }
 
+void list_node_set(struct list *self, struct list_node *node, size_t index, int value) {
+  int old_value = node->data;
+  node->data = value;
+  notify_set(self, node, index, old_value);
+}
+
 size_t list_search(const struct list *self, int value) {
+  if(list_index_usable(self)){
+    size_t position;
+    list_index_find(self, value, &position, NULL);
+    return position;
+  }
   struct list_node *curr = self->first;
-  for(size_t i=0; i<list_size(self);++i){
+  size_t i = 0;
+  while(curr != NULL){
     if(curr->data == value) return i;
     curr = curr->next;
+    ++i;
   }
-  return list_size(self);
+  return i;
 }
 
 bool list_is_sorted(const struct list *self) {
@@ -191,8 +325,10 @@ void list_split(struct list *self, struct list *out1, struct list *out2) {
     else list_push_back(out2,curr->data);
     curr=curr->next;
   }
-  list_destroy(self);
+  node_destroy(self, self->first);
   self->first = NULL;
+  if(self->index != NULL) list_index_clear(self->index);
+  if(self->fingerprint != NULL) list_fingerprint_clear(self->fingerprint);
 }
 
 
@@ -222,17 +358,37 @@ void list_merge(struct list *self, struct list *in1, struct list *in2) {
 }
 
 void list_merge_sort(struct list *self) {
-  if(list_size(self) == 1){
+  if(self->first == NULL || self->first->next == NULL){
     return;
   }
+  // the halves are relinked many times, the index and the fingerprint are rebuilt once at the end
+  struct list_index *index = self->index;
+  struct list_fingerprint *fingerprint = self->fingerprint;
+  self->index = NULL;
+  self->fingerprint = NULL;
   struct list *part1 = malloc(sizeof(struct list));
   struct list *part2 = malloc(sizeof(struct list));
-  list_create(part1);
-  list_create(part2);
+  list_create_with_allocator(part1, self->allocator);
+  list_create_with_allocator(part2, self->allocator);
   list_split(self, part1, part2);
   list_merge_sort(part1);
   list_merge_sort(part2);
   list_merge(self, part1, part2);
   free(part1);
   free(part2);
+  self->index = index;
+  self->fingerprint = fingerprint;
+  list_relinked(self);
+}
+
+bool list_equals_list(const struct list *self, const struct list *other) {
+  if(list_fingerprint_differ(self, other)) return false;
+  struct list_node *lhs = self->first;
+  struct list_node *rhs = other->first;
+  while(lhs != NULL && rhs != NULL){
+    if(lhs->data != rhs->data) return false;
+    lhs = lhs->next;
+    rhs = rhs->next;
+  }
+  return lhs == NULL && rhs == NULL;
 }
@@ -13,8 +13,25 @@ struct list_node {
   struct list_node *next;
 };
 
+/*
+ * Allocator of the nodes of a list, ctx is given back to both functions
+ */
+struct list_allocator {
+  struct list_node *(*allocate)(void *ctx);
+  void (*deallocate)(void *ctx, struct list_node *node);
+  void *ctx;
+};
+
+/*
+ * Predicate on a value, ctx is given back to it
+ */
+typedef bool (*list_value_predicate)(int value, void *ctx);
+
 struct list {
   struct list_node *first;
+  const struct list_allocator *allocator; // NULL for malloc and free
+  struct list_index *index; // NULL unless attached, see listIndex.h
+  struct list_fingerprint *fingerprint; // NULL unless attached, see listFingerprint.h
 };
 
 /*
@@ -22,6 +39,11 @@ struct list {
  */
 void list_create(struct list *self);
 
+/*
+ * Create an empty list whose nodes come from an allocator (NULL for malloc and free)
+ */
+void list_create_with_allocator(struct list *self, const struct list_allocator *allocator);
+
 /*
  * Create a list with initial content
  */
@@ -32,13 +54,29 @@ void list_create_from(struct list *self, const int *other, size_t size);
  */
 void list_destroy(struct list *self);
 
+/*
+ * Allocate a node with the allocator of the list, the node is not linked.
+ * Abort if the allocation failed.
+ */
+struct list_node *list_node_create(const struct list *self, int value);
+
+/*
+ * Same as list_node_create, but return NULL if the allocation failed
+ */
+struct list_node *list_node_try_create(const struct list *self, int value);
+
+/*
+ * Give a node that is not linked anymore back to the allocator of the list
+ */
+void list_node_destroy(const struct list *self, struct list_node *node);
+
 /*
  * Tell if the list is empty
  */
 bool list_empty(const struct list *self);
 
 /*
- * Get the size of the list
+ * Get the size of the list, O(1) when the list has a fingerprint attached
  */
 size_t list_size(const struct list *self);
 
@@ -47,6 +85,11 @@ size_t list_size(const struct list *self);
  */
 bool list_equals(const struct list *self, const int *data, size_t size);
 
+/*
+ * Compare two lists, rejected without a walk when their fingerprints differ
+ */
+bool list_equals_list(const struct list *self, const struct list *other);
+
 /*
  * Add an element in the list at the beginning
  */
@@ -79,6 +122,32 @@ void list_insert(struct list *self, int value, size_t index);
  */
 void list_remove(struct list *self, size_t index);
 
+/*
+ * Unlink the node at index and return it without freeing it (preserving the order)
+ * index is valid
+ */
+struct list_node *list_extract(struct list *self, size_t index);
+
+/*
+ * Link a node at index (preserving the order), the node must come from the allocator of the list
+ * index is valid or equals to the size of the list (insert at the end)
+ */
+void list_insert_node(struct list *self, struct list_node *node, size_t index);
+
+/*
+ * Keep the index and the fingerprint of a list up to date when its nodes
+ * are linked by hand: after linking a node at the end, or after any other
+ * relinking or change of values
+ */
+void list_node_appended(struct list *self, struct list_node *node);
+void list_relinked(struct list *self);
+
+/*
+ * Set the value of a node of the list, index is its position. Writes to
+ * node->data must go through it when an index or a fingerprint is attached.
+ */
+void list_node_set(struct list *self, struct list_node *node, size_t index, int value);
+
 /*
  * Get the element at the specified index in the list or 0 if the index is not valid
  */
@@ -91,6 +160,7 @@ void list_set(struct list *self, size_t index, int value);
 
 /*
  * Search for an element in the list and return its index or the size of the list if not present.
+ * O(1) when the list has an index attached.
  */
 size_t list_search(const struct list *self, int value);
 
@@ -0,0 +1,345 @@
+#ifndef LINKED_LIST_HPP
+#define LINKED_LIST_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "linkedList.h"
+
+/*
+ * Owning wrapper around struct list. Moving a linked_list only steals the
+ * node chain, a deep copy has to be asked for with clone(). Nodes can be
+ * moved between lists without reallocation with extract / insert.
+ */
+class linked_list {
+public:
+  /*
+   * Owns one unlinked node, given back to its allocator if never inserted
+   */
+  class node_handle {
+  public:
+    node_handle() noexcept : node(nullptr), allocator(nullptr) {}
+
+    node_handle(node_handle &&other) noexcept : node(other.node), allocator(other.allocator) {
+      other.node = nullptr;
+    }
+
+    node_handle &operator=(node_handle &&other) noexcept {
+      if (this != &other) {
+        reset();
+        node = other.node;
+        allocator = other.allocator;
+        other.node = nullptr;
+      }
+      return *this;
+    }
+
+    node_handle(const node_handle &) = delete;
+    node_handle &operator=(const node_handle &) = delete;
+
+    ~node_handle() { reset(); }
+
+    bool empty() const noexcept { return node == nullptr; }
+    explicit operator bool() const noexcept { return node != nullptr; }
+
+    int &value() { return node->data; }
+    int value() const { return node->data; }
+
+  private:
+    friend class linked_list;
+
+    node_handle(struct list_node *node, const struct list_allocator *allocator) noexcept : node(node), allocator(allocator) {}
+
+    void reset() noexcept {
+      if (node != nullptr) {
+        struct list owner;
+        list_create_with_allocator(&owner, allocator);
+        list_node_destroy(&owner, node);
+        node = nullptr;
+      }
+    }
+
+    struct list_node *release() noexcept {
+      struct list_node *released = node;
+      node = nullptr;
+      return released;
+    }
+
+    struct list_node *node;
+    const struct list_allocator *allocator;
+  };
+
+  /*
+   * Reference to the value of a linked node, writes go through
+   * list_node_set so that the index and the fingerprint see them. The
+   * position of the node is looked up at write time, and only when one of
+   * them is attached (O(n) then), so that the reference stays valid when
+   * other nodes are inserted or removed.
+   */
+  class value_reference {
+  public:
+    value_reference(const value_reference &) = default;
+
+    operator int() const noexcept { return node->data; }
+
+    value_reference &operator=(int value) {
+      std::size_t position = 0;
+      if (owner->index != nullptr || owner->fingerprint != nullptr) {
+        for (struct list_node *curr = owner->first; curr != node; curr = curr->next) {
+          ++position;
+        }
+      }
+      list_node_set(owner, node, position, value);
+      return *this;
+    }
+
+    value_reference &operator=(const value_reference &other) { return *this = int(other); }
+    value_reference &operator+=(int value) { return *this = node->data + value; }
+    value_reference &operator-=(int value) { return *this = node->data - value; }
+    value_reference &operator*=(int value) { return *this = node->data * value; }
+
+  private:
+    friend class linked_list;
+
+    value_reference(struct list *owner, struct list_node *node) noexcept : owner(owner), node(node) {}
+
+    struct list *owner;
+    struct list_node *node;
+  };
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = int;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const int *;
+    using reference = value_reference;
+
+    iterator() noexcept : owner(nullptr), node(nullptr) {}
+
+    reference operator*() const { return value_reference(owner, node); }
+    pointer operator->() const { return &node->data; }
+
+    iterator &operator++() {
+      node = node->next;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const iterator &other) const { return node == other.node; }
+    bool operator!=(const iterator &other) const { return node != other.node; }
+
+  private:
+    friend class linked_list;
+
+    iterator(struct list *owner, struct list_node *node) noexcept : owner(owner), node(node) {}
+
+    struct list *owner;
+    struct list_node *node;
+  };
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = int;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const int *;
+    using reference = const int &;
+
+    explicit const_iterator(const struct list_node *node = nullptr) noexcept : node(node) {}
+
+    reference operator*() const { return node->data; }
+    pointer operator->() const { return &node->data; }
+
+    const_iterator &operator++() {
+      node = node->next;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator copy = *this;
+      node = node->next;
+      return copy;
+    }
+
+    bool operator==(const const_iterator &other) const { return node == other.node; }
+    bool operator!=(const const_iterator &other) const { return node != other.node; }
+
+  private:
+    const struct list_node *node;
+  };
+
+  linked_list() noexcept { list_create(&raw); }
+
+  explicit linked_list(const struct list_allocator *allocator) noexcept {
+    list_create_with_allocator(&raw, allocator);
+  }
+
+  linked_list(std::initializer_list<int> values) {
+    list_create(&raw);
+    append(values.begin(), values.end());
+  }
+
+  /*
+   * Take ownership of the nodes of a list, which is left empty
+   */
+  static linked_list adopt(struct list &other) noexcept {
+    linked_list l(other.allocator);
+    l.raw.first = other.first;
+    l.raw.index = other.index;
+    l.raw.fingerprint = other.fingerprint;
+    other.first = nullptr;
+    other.index = nullptr;
+    other.fingerprint = nullptr;
+    return l;
+  }
+
+  linked_list(const linked_list &) = delete;
+  linked_list &operator=(const linked_list &) = delete;
+
+  linked_list(linked_list &&other) noexcept : raw(other.raw) {
+    list_create_with_allocator(&other.raw, raw.allocator);
+  }
+
+  linked_list &operator=(linked_list &&other) noexcept {
+    if (this != &other) {
+      list_destroy(&raw);
+      raw = other.raw;
+      list_create_with_allocator(&other.raw, raw.allocator);
+    }
+    return *this;
+  }
+
+  ~linked_list() { list_destroy(&raw); }
+
+  /*
+   * Deep copy, with the same allocator
+   */
+  linked_list clone() const {
+    linked_list copy(raw.allocator);
+    copy.append(begin(), end());
+    return copy;
+  }
+
+  bool empty() const noexcept { return list_empty(&raw); }
+  std::size_t size() const noexcept { return list_size(&raw); }
+
+  value_reference emplace_front(int value) {
+    list_push_front(&raw, value);
+    return value_reference(&raw, raw.first);
+  }
+
+  value_reference emplace_back(int value) {
+    struct list_node *node = list_node_create(&raw, value);
+    *last_link() = node;
+    list_node_appended(&raw, node);
+    return value_reference(&raw, node);
+  }
+
+  void push_front(int value) { emplace_front(value); }
+  void push_back(int value) { emplace_back(value); }
+  void pop_front() { list_pop_front(&raw); }
+  void pop_back() { list_pop_back(&raw); }
+
+  void insert(std::size_t index, int value) { list_insert(&raw, value, index); }
+  void remove(std::size_t index) { list_remove(&raw, index); }
+
+  int get(std::size_t index) const { return list_get(&raw, index); }
+  void set(std::size_t index, int value) { list_set(&raw, index, value); }
+  std::size_t search(int value) const { return list_search(&raw, value); }
+
+  bool is_sorted() const { return list_is_sorted(&raw); }
+  void merge_sort() { list_merge_sort(&raw); }
+
+  bool equals(const int *data, std::size_t size) const { return list_equals(&raw, data, size); }
+
+  /*
+   * Unlink the node at index, index is valid
+   */
+  node_handle extract(std::size_t index) {
+    return node_handle(list_extract(&raw, index), raw.allocator);
+  }
+
+  /*
+   * Link the node of a handle at index. The node is moved as is when it comes
+   * from the same allocator, otherwise its value is copied in a new node.
+   */
+  void insert(std::size_t index, node_handle &&handle) {
+    if (handle.empty()) {
+      return;
+    }
+    if (handle.allocator == raw.allocator) {
+      list_insert_node(&raw, handle.release(), index);
+    } else {
+      list_insert(&raw, handle.value(), index);
+      handle.reset();
+    }
+  }
+
+  void push_front(node_handle &&handle) { insert(0, std::move(handle)); }
+
+  void push_back(node_handle &&handle) {
+    if (handle.allocator == raw.allocator && !handle.empty()) {
+      struct list_node *node = handle.release();
+      *last_link() = node;
+      list_node_appended(&raw, node);
+    } else if (!handle.empty()) {
+      emplace_back(handle.value());
+      handle.reset();
+    }
+  }
+
+  iterator begin() noexcept { return iterator(&raw, raw.first); }
+  iterator end() noexcept { return iterator(); }
+  const_iterator begin() const noexcept { return const_iterator(raw.first); }
+  const_iterator end() const noexcept { return const_iterator(); }
+
+  struct list *c_list() noexcept { return &raw; }
+  const struct list *c_list() const noexcept { return &raw; }
+
+private:
+  struct list_node **last_link() noexcept {
+    struct list_node **link = &raw.first;
+    while (*link != nullptr) {
+      link = &(*link)->next;
+    }
+    return link;
+  }
+
+  template<typename Iterator>
+  void append(Iterator first, Iterator last) {
+    struct list_node **link = last_link();
+    for (; first != last; ++first) {
+      struct list_node *node = list_node_create(&raw, *first);
+      *link = node;
+      link = &node->next;
+      list_node_appended(&raw, node);
+    }
+  }
+
+  struct list raw;
+};
+
+inline bool operator==(const linked_list &lhs, const linked_list &rhs) {
+  auto it = rhs.begin();
+  for (int value : lhs) {
+    if (it == rhs.end() || *it != value) {
+      return false;
+    }
+    ++it;
+  }
+  return it == rhs.end();
+}
+
+inline bool operator!=(const linked_list &lhs, const linked_list &rhs) {
+  return !(lhs == rhs);
+}
+
+#endif // LINKED_LIST_HPP
@@ -0,0 +1,12 @@
+#ifndef LIST_ATOMIC_H
+#define LIST_ATOMIC_H
+
+/*
+ * Internal atomic accesses of listQueue.c and rcuList.c. list_node is
+ * shared with the rest of the library, so the links use the GCC builtins
+ * instead of changing next to an _Atomic pointer.
+ */
+#define LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+
+#endif // LIST_ATOMIC_H
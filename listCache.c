@@ -0,0 +1,246 @@
+#include "listCache.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashTable.h"
+#include "intrusiveList.h"
+
+#define LIST_CACHE_MIN_BITS 4
+
+enum {
+  CACHE_PROBATION,
+  CACHE_MAIN,
+  CACHE_QUEUES,
+};
+
+struct list_cache_entry {
+  struct ilist_link link;
+  struct ilist_link *prev; // NULL for the first entry of its queue
+  size_t cost;
+  int key;
+  int value;
+  unsigned queue;
+};
+
+/*
+ * Most recently inserted or used first, the victims are taken at the end
+ */
+struct list_cache_queue {
+  struct ilist list;
+  struct ilist_link *last;
+  size_t usage;
+};
+
+/*
+ * Slot of the hash table, entry is NULL when empty
+ */
+struct list_cache_slot {
+  struct list_cache_entry *entry;
+  int key;
+};
+
+struct list_cache {
+  struct list_cache_queue queues[CACHE_QUEUES];
+  struct hash_table table;
+  size_t capacity;
+  enum list_cache_unit unit;
+  enum list_cache_policy policy;
+  struct ilist spare; // entries evicted or removed, reused by the next insertions
+  struct list_cache_stats stats;
+};
+
+static struct list_cache_entry *cache_entry(struct ilist_link *link) {
+  return ilist_entry(link, struct list_cache_entry, link);
+}
+
+static void queue_push_front(struct list_cache *self, unsigned queue, struct list_cache_entry *entry) {
+  struct list_cache_queue *q = &self->queues[queue];
+  struct ilist_link *first = q->list.first;
+  ilist_insert_after(&q->list, NULL, &entry->link);
+  entry->prev = NULL;
+  entry->queue = queue;
+  if(first != NULL){
+    cache_entry(first)->prev = &entry->link;
+  }
+  else{
+    q->last = &entry->link;
+  }
+  q->usage += entry->cost;
+}
+
+static void queue_unlink(struct list_cache *self, struct list_cache_entry *entry) {
+  struct list_cache_queue *q = &self->queues[entry->queue];
+  struct ilist_link *next = entry->link.next;
+  ilist_remove_after(&q->list, entry->prev);
+  if(next != NULL){
+    cache_entry(next)->prev = entry->prev;
+  }
+  else{
+    q->last = entry->prev;
+  }
+  q->usage -= entry->cost;
+}
+
+static struct list_cache_slot *table_lookup(const struct list_cache *self, int key) {
+  return hash_table_find(&self->table, key);
+}
+
+/*
+ * Unlink an entry from its queue and the table, keep it for a later insertion
+ */
+static void cache_drop(struct list_cache *self, struct list_cache_slot *slot) {
+  struct list_cache_entry *entry = slot->entry;
+  queue_unlink(self, entry);
+  hash_table_remove(&self->table, slot);
+  ilist_push_front(&self->spare, &entry->link);
+}
+
+static void cache_evict(struct list_cache *self) {
+  struct list_cache_queue *probation = &self->queues[CACHE_PROBATION];
+  struct list_cache_queue *lru = &self->queues[CACHE_MAIN];
+  // 2Q: the probation queue gives its entries back past a quarter of the capacity
+  bool from_probation = probation->last != NULL && (lru->last == NULL || probation->usage > self->capacity / 4);
+  struct list_cache_queue *victims = from_probation ? probation : lru;
+  assert(victims->last != NULL);
+  cache_drop(self, table_lookup(self, cache_entry(victims->last)->key));
+  ++self->stats.evictions;
+}
+
+static size_t cache_usage(const struct list_cache *self) {
+  return self->queues[CACHE_PROBATION].usage + self->queues[CACHE_MAIN].usage;
+}
+
+static size_t cache_cost(const struct list_cache *self, size_t charge) {
+  return (self->unit == LIST_CACHE_ENTRIES) ? 1 : sizeof(struct list_cache_entry) + charge;
+}
+
+static void cache_free(struct ilist *entries) {
+  struct ilist_link *link;
+  while((link = ilist_pop_front(entries)) != NULL){
+    free(cache_entry(link));
+  }
+}
+
+struct list_cache *list_cache_create(size_t capacity, enum list_cache_unit unit, enum list_cache_policy policy) {
+  struct list_cache *self = malloc(sizeof(struct list_cache));
+  if(self == NULL) return NULL;
+  for(unsigned i=0; i<CACHE_QUEUES; ++i){
+    ilist_create(&self->queues[i].list);
+    self->queues[i].last = NULL;
+    self->queues[i].usage = 0;
+  }
+  self->capacity = capacity;
+  self->unit = unit;
+  self->policy = policy;
+  ilist_create(&self->spare);
+  memset(&self->stats, 0, sizeof(self->stats));
+  if(!hash_table_create(&self->table, sizeof(struct list_cache_slot), offsetof(struct list_cache_slot, key), LIST_CACHE_MIN_BITS)){
+    free(self);
+    return NULL;
+  }
+  return self;
+}
+
+void list_cache_destroy(struct list_cache *self) {
+  for(unsigned i=0; i<CACHE_QUEUES; ++i){
+    cache_free(&self->queues[i].list);
+  }
+  cache_free(&self->spare);
+  hash_table_destroy(&self->table);
+  free(self);
+}
+
+bool list_cache_get(struct list_cache *self, int key, int *value) {
+  struct list_cache_slot *slot = table_lookup(self, key);
+  if(slot == NULL){
+    ++self->stats.misses;
+    return false;
+  }
+  struct list_cache_entry *entry = slot->entry;
+  ++self->stats.hits;
+  if(entry->queue == CACHE_PROBATION){
+    ++self->stats.promotions;
+  }
+  queue_unlink(self, entry);
+  queue_push_front(self, CACHE_MAIN, entry);
+  if(value != NULL){
+    *value = entry->value;
+  }
+  return true;
+}
+
+bool list_cache_put(struct list_cache *self, int key, int value, size_t charge) {
+  size_t cost = cache_cost(self, charge);
+  if(cost > self->capacity) return false;
+
+  struct list_cache_slot *slot = table_lookup(self, key);
+  if(slot != NULL){
+    // an update counts as an access
+    struct list_cache_entry *entry = slot->entry;
+    if(entry->queue == CACHE_PROBATION){
+      ++self->stats.promotions;
+    }
+    queue_unlink(self, entry);
+    while(cache_usage(self) + cost > self->capacity){
+      cache_evict(self);
+    }
+    entry->value = value;
+    entry->cost = cost;
+    queue_push_front(self, CACHE_MAIN, entry);
+    return true;
+  }
+
+  // allocate before evicting anything, so that a failure leaves the cache as it is
+  if(!hash_table_reserve(&self->table)) return false;
+  struct ilist_link *spare = ilist_pop_front(&self->spare);
+  struct list_cache_entry *entry = (spare != NULL) ? cache_entry(spare) : malloc(sizeof(struct list_cache_entry));
+  if(entry == NULL) return false;
+  while(cache_usage(self) + cost > self->capacity){
+    cache_evict(self);
+  }
+  entry->key = key;
+  entry->value = value;
+  entry->cost = cost;
+  // the evictions only freed slots, the reserved one is still there
+  slot = hash_table_insert(&self->table, key);
+  slot->entry = entry;
+  slot->key = key;
+  queue_push_front(self, (self->policy == LIST_CACHE_2Q) ? CACHE_PROBATION : CACHE_MAIN, entry);
+  ++self->stats.insertions;
+  return true;
+}
+
+bool list_cache_remove(struct list_cache *self, int key) {
+  struct list_cache_slot *slot = table_lookup(self, key);
+  if(slot == NULL) return false;
+  cache_drop(self, slot);
+  return true;
+}
+
+bool list_cache_contains(const struct list_cache *self, int key) {
+  return table_lookup(self, key) != NULL;
+}
+
+void list_cache_clear(struct list_cache *self) {
+  for(unsigned i=0; i<CACHE_QUEUES; ++i){
+    cache_free(&self->queues[i].list);
+    self->queues[i].last = NULL;
+    self->queues[i].usage = 0;
+  }
+  cache_free(&self->spare);
+  hash_table_clear(&self->table);
+}
+
+size_t list_cache_size(const struct list_cache *self) {
+  return self->table.used;
+}
+
+size_t list_cache_usage(const struct list_cache *self) {
+  return cache_usage(self);
+}
+
+struct list_cache_stats list_cache_stats(const struct list_cache *self) {
+  return self->stats;
+}
@@ -0,0 +1,102 @@
+#ifndef LIST_CACHE_H
+#define LIST_CACHE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Key value cache with O(1) get, put and eviction. The entries are linked
+ * in intrusive lists ordered by recency, each one remembers its
+ * predecessor so that it can be unlinked and moved to the front without
+ * a walk, and an embedded hash table maps the keys to the entries.
+ */
+struct list_cache;
+
+enum list_cache_policy {
+  // evict the least recently used entry
+  LIST_CACHE_LRU,
+  // simplified 2Q: new entries wait in a FIFO probation queue holding a
+  // quarter of the capacity and are promoted to an LRU queue on their
+  // second access, so that one-time accesses (scans) cannot flush the
+  // frequently used entries
+  LIST_CACHE_2Q,
+};
+
+enum list_cache_unit {
+  // every entry costs 1
+  LIST_CACHE_ENTRIES,
+  // every entry costs its charge plus its own memory
+  LIST_CACHE_BYTES,
+};
+
+struct list_cache_stats {
+  size_t hits;
+  size_t misses;
+  size_t insertions;
+  size_t evictions;
+  size_t promotions; // from probation to the LRU queue (2Q)
+};
+
+/*
+ * Create an empty cache, return NULL if it failed
+ */
+struct list_cache *list_cache_create(size_t capacity, enum list_cache_unit unit, enum list_cache_policy policy);
+
+/*
+ * Destroy a cache
+ */
+void list_cache_destroy(struct list_cache *self);
+
+/*
+ * Look a key up, on a hit the entry becomes the most recently used one and
+ * its value is stored in value (if not NULL)
+ */
+bool list_cache_get(struct list_cache *self, int key, int *value);
+
+/*
+ * Insert or update a key, evicting entries until everything fits. charge is
+ * the size of what the caller associates to the entry, it is only used in
+ * LIST_CACHE_BYTES. Return false (and leave the cache as it is) if the
+ * entry alone exceeds the capacity or the allocation failed.
+ */
+bool list_cache_put(struct list_cache *self, int key, int value, size_t charge);
+
+/*
+ * Remove a key, return false if it was not present
+ */
+bool list_cache_remove(struct list_cache *self, int key);
+
+/*
+ * Tell if a key is present, without touching the recency nor the stats
+ */
+bool list_cache_contains(const struct list_cache *self, int key);
+
+/*
+ * Remove all the entries, the stats are kept
+ */
+void list_cache_clear(struct list_cache *self);
+
+/*
+ * Get the number of entries
+ */
+size_t list_cache_size(const struct list_cache *self);
+
+/*
+ * Get the cost of all the entries, in the unit of the capacity
+ */
+size_t list_cache_usage(const struct list_cache *self);
+
+/*
+ * Get the counters since the creation
+ */
+struct list_cache_stats list_cache_stats(const struct list_cache *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIST_CACHE_H
@@ -0,0 +1,41 @@
+#ifndef LIST_CHAIN_H
+#define LIST_CHAIN_H
+
+#include <stddef.h>
+
+#include "linkedList.h"
+
+/*
+ * Internal chain of nodes being relinked, used by listSelect.c and
+ * parallelList.c to partition a list without allocating. The last node is
+ * not terminated until the chain is linked somewhere.
+ */
+struct list_chain {
+  struct list_node *first;
+  struct list_node *last;
+  size_t size;
+};
+
+#define LIST_CHAIN_EMPTY { NULL, NULL, 0 }
+
+static inline void list_chain_append(struct list_chain *self, struct list_node *node) {
+  if(self->last == NULL){
+    self->first = node;
+  }
+  else{
+    self->last->next = node;
+  }
+  self->last = node;
+  ++self->size;
+}
+
+/*
+ * Link a chain after *link and return the link after its last node
+ */
+static inline struct list_node **list_chain_link(struct list_node **link, const struct list_chain *self) {
+  if(self->first == NULL) return link;
+  *link = self->first;
+  return &self->last->next;
+}
+
+#endif // LIST_CHAIN_H
@@ -0,0 +1,229 @@
+#include "listFingerprint.h"
+
+#include <stdlib.h>
+
+// odd, so invertible modulo 2^64
+#define FINGERPRINT_BASE UINT64_C(0x100000001b3)
+
+struct list_fingerprint {
+  uint64_t hash;
+  uint64_t power; // B^size
+  size_t size;
+  int min;
+  int max;
+  bool stale; // min and max have to be recomputed
+};
+
+/*
+ * Bijective mix of a value, so that the hash is not linear in the values
+ */
+static uint64_t fingerprint_mix(int value) {
+  uint64_t z = (uint64_t)(uint32_t)value + UINT64_C(0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return z ^ (z >> 31);
+}
+
+/*
+ * Inverse of B modulo 2^64 by Newton iteration, each step doubles the correct bits
+ */
+static uint64_t fingerprint_inverse(void) {
+  uint64_t inverse = FINGERPRINT_BASE;
+  for(int i=0; i<5; ++i){
+    inverse *= 2 - FINGERPRINT_BASE * inverse;
+  }
+  return inverse;
+}
+
+static uint64_t fingerprint_power(size_t exponent) {
+  uint64_t result = 1;
+  uint64_t base = FINGERPRINT_BASE;
+  while(exponent > 0){
+    if(exponent & 1){
+      result *= base;
+    }
+    base *= base;
+    exponent >>= 1;
+  }
+  return result;
+}
+
+/*
+ * Sum of mix(value) * B^i over the first count nodes, *power receives B^count
+ */
+static uint64_t fingerprint_prefix(const struct list_node *first, size_t count, uint64_t *power) {
+  uint64_t hash = 0;
+  uint64_t p = 1;
+  for(size_t i=0; i<count; ++i){
+    hash += fingerprint_mix(first->data) * p;
+    p *= FINGERPRINT_BASE;
+    first = first->next;
+  }
+  *power = p;
+  return hash;
+}
+
+static void fingerprint_add_value(struct list_fingerprint *fingerprint, int value) {
+  if(fingerprint->size == 1){
+    fingerprint->min = value;
+    fingerprint->max = value;
+    fingerprint->stale = false;
+  }
+  else if(!fingerprint->stale){
+    if(value < fingerprint->min) fingerprint->min = value;
+    if(value > fingerprint->max) fingerprint->max = value;
+  }
+}
+
+static void fingerprint_remove_value(struct list_fingerprint *fingerprint, int value) {
+  if(fingerprint->size == 0){
+    fingerprint->stale = false;
+  }
+  else if(value == fingerprint->min || value == fingerprint->max){
+    fingerprint->stale = true;
+  }
+}
+
+bool list_fingerprint_attach(struct list *self) {
+  if(self->fingerprint != NULL) return true;
+  struct list_fingerprint *fingerprint = malloc(sizeof(struct list_fingerprint));
+  if(fingerprint == NULL) return false;
+  self->fingerprint = fingerprint;
+  list_fingerprint_rebuild(self);
+  return true;
+}
+
+void list_fingerprint_detach(struct list *self) {
+  free(self->fingerprint);
+  self->fingerprint = NULL;
+}
+
+void list_fingerprint_rebuild(struct list *self) {
+  struct list_fingerprint *fingerprint = self->fingerprint;
+  if(fingerprint == NULL) return;
+  list_fingerprint_clear(fingerprint);
+  for(struct list_node *curr = self->first; curr != NULL; curr = curr->next){
+    list_fingerprint_on_push_back(fingerprint, curr);
+  }
+}
+
+uint64_t list_fingerprint_hash(const struct list *self) {
+  if(self->fingerprint != NULL) return self->fingerprint->hash;
+  uint64_t hash = 0;
+  uint64_t power = 1;
+  for(struct list_node *curr = self->first; curr != NULL; curr = curr->next){
+    hash += fingerprint_mix(curr->data) * power;
+    power *= FINGERPRINT_BASE;
+  }
+  return hash;
+}
+
+uint64_t list_fingerprint_array(const int *data, size_t size) {
+  uint64_t hash = 0;
+  uint64_t power = 1;
+  for(size_t i=0; i<size; ++i){
+    hash += fingerprint_mix(data[i]) * power;
+    power *= FINGERPRINT_BASE;
+  }
+  return hash;
+}
+
+bool list_fingerprint_size(const struct list *self, size_t *size) {
+  if(self->fingerprint == NULL) return false;
+  *size = self->fingerprint->size;
+  return true;
+}
+
+bool list_fingerprint_differ(const struct list *self, const struct list *other) {
+  const struct list_fingerprint *lhs = self->fingerprint;
+  const struct list_fingerprint *rhs = other->fingerprint;
+  if(lhs == NULL || rhs == NULL) return false;
+  if(lhs->size != rhs->size || lhs->hash != rhs->hash) return true;
+  return lhs->size > 0 && !lhs->stale && !rhs->stale && (lhs->min != rhs->min || lhs->max != rhs->max);
+}
+
+bool list_min_max(const struct list *self, int *min, int *max) {
+  struct list_fingerprint *fingerprint = self->fingerprint;
+  if(self->first == NULL) return false;
+  if(fingerprint != NULL && !fingerprint->stale){
+    *min = fingerprint->min;
+    *max = fingerprint->max;
+    return true;
+  }
+  *min = self->first->data;
+  *max = self->first->data;
+  for(struct list_node *curr = self->first->next; curr != NULL; curr = curr->next){
+    if(curr->data < *min) *min = curr->data;
+    if(curr->data > *max) *max = curr->data;
+  }
+  if(fingerprint != NULL){
+    fingerprint->min = *min;
+    fingerprint->max = *max;
+    fingerprint->stale = false;
+  }
+  return true;
+}
+
+void list_fingerprint_on_push_front(struct list_fingerprint *fingerprint, struct list_node *node) {
+  fingerprint->hash = fingerprint_mix(node->data) + FINGERPRINT_BASE * fingerprint->hash;
+  fingerprint->power *= FINGERPRINT_BASE;
+  ++fingerprint->size;
+  fingerprint_add_value(fingerprint, node->data);
+}
+
+void list_fingerprint_on_push_back(struct list_fingerprint *fingerprint, struct list_node *node) {
+  fingerprint->hash += fingerprint_mix(node->data) * fingerprint->power;
+  fingerprint->power *= FINGERPRINT_BASE;
+  ++fingerprint->size;
+  fingerprint_add_value(fingerprint, node->data);
+}
+
+void list_fingerprint_on_insert(struct list_fingerprint *fingerprint, const struct list_node *first, struct list_node *node, size_t position) {
+  // the nodes before position keep their weight, the others get one more B
+  uint64_t power;
+  uint64_t low = fingerprint_prefix(first, position, &power);
+  fingerprint->hash = low + fingerprint_mix(node->data) * power + FINGERPRINT_BASE * (fingerprint->hash - low);
+  fingerprint->power *= FINGERPRINT_BASE;
+  ++fingerprint->size;
+  fingerprint_add_value(fingerprint, node->data);
+}
+
+void list_fingerprint_on_pop_front(struct list_fingerprint *fingerprint, struct list_node *node) {
+  uint64_t inverse = fingerprint_inverse();
+  fingerprint->hash = (fingerprint->hash - fingerprint_mix(node->data)) * inverse;
+  fingerprint->power *= inverse;
+  --fingerprint->size;
+  fingerprint_remove_value(fingerprint, node->data);
+}
+
+void list_fingerprint_on_pop_back(struct list_fingerprint *fingerprint, struct list_node *node) {
+  fingerprint->power *= fingerprint_inverse();
+  fingerprint->hash -= fingerprint_mix(node->data) * fingerprint->power;
+  --fingerprint->size;
+  fingerprint_remove_value(fingerprint, node->data);
+}
+
+void list_fingerprint_on_remove(struct list_fingerprint *fingerprint, const struct list_node *first, struct list_node *node, size_t position) {
+  uint64_t power;
+  uint64_t low = fingerprint_prefix(first, position, &power);
+  uint64_t inverse = fingerprint_inverse();
+  fingerprint->hash = low + (fingerprint->hash - low - fingerprint_mix(node->data) * power) * inverse;
+  fingerprint->power *= inverse;
+  --fingerprint->size;
+  fingerprint_remove_value(fingerprint, node->data);
+}
+
+void list_fingerprint_on_set(struct list_fingerprint *fingerprint, struct list_node *node, size_t position, int old_value) {
+  fingerprint->hash += (fingerprint_mix(node->data) - fingerprint_mix(old_value)) * fingerprint_power(position);
+  fingerprint_remove_value(fingerprint, old_value);
+  fingerprint_add_value(fingerprint, node->data);
+}
+
+void list_fingerprint_clear(struct list_fingerprint *fingerprint) {
+  fingerprint->hash = 0;
+  fingerprint->power = 1;
+  fingerprint->size = 0;
+  fingerprint->min = 0;
+  fingerprint->max = 0;
+  fingerprint->stale = false;
+}
@@ -0,0 +1,87 @@
+#ifndef LIST_FINGERPRINT_H
+#define LIST_FINGERPRINT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Optional fingerprint of a list: its size, its minimum and maximum and an
+ * order sensitive hash, sum of mix(value[i]) * B^i modulo 2^64 with an odd
+ * B. Once attached, it is kept up to date by the functions of linkedList.h:
+ * list_size becomes O(1) and list_equals / list_equals_list reject most
+ * mismatches without walking.
+ *
+ * push and pop at both ends and set are O(1), insert and remove walk the
+ * nodes before the position once more. Removing the minimum or the maximum
+ * makes them stale, they are recomputed by the next list_min_max.
+ */
+struct list_fingerprint;
+
+/*
+ * Attach a fingerprint computed from the current content of the list, return false if the allocation failed
+ */
+bool list_fingerprint_attach(struct list *self);
+
+/*
+ * Detach and free the fingerprint of a list, if any
+ */
+void list_fingerprint_detach(struct list *self);
+
+/*
+ * Recompute the fingerprint from the content of the list, if any
+ */
+void list_fingerprint_rebuild(struct list *self);
+
+/*
+ * Get the hash of a list, computed by a walk if it has no fingerprint
+ */
+uint64_t list_fingerprint_hash(const struct list *self);
+
+/*
+ * Get the hash of an array, equal to the hash of a list with the same values
+ */
+uint64_t list_fingerprint_array(const int *data, size_t size);
+
+/*
+ * Get the cached size of the list, return false if it has no fingerprint
+ */
+bool list_fingerprint_size(const struct list *self, size_t *size);
+
+/*
+ * Tell if the fingerprints of two lists prove that they are different.
+ * false if they may be equal, or if one of them has no fingerprint.
+ */
+bool list_fingerprint_differ(const struct list *self, const struct list *other);
+
+/*
+ * Get the minimum and the maximum of a list, return false if it is empty.
+ * O(1) with a fingerprint unless they are stale, a walk otherwise.
+ */
+bool list_min_max(const struct list *self, int *min, int *max);
+
+/*
+ * Maintenance, called by linkedList.c after the list has been relinked.
+ * first is the first node of the list after the change, a removed node is
+ * still readable during the call.
+ */
+void list_fingerprint_on_push_front(struct list_fingerprint *fingerprint, struct list_node *node);
+void list_fingerprint_on_push_back(struct list_fingerprint *fingerprint, struct list_node *node);
+void list_fingerprint_on_insert(struct list_fingerprint *fingerprint, const struct list_node *first, struct list_node *node, size_t position);
+void list_fingerprint_on_pop_front(struct list_fingerprint *fingerprint, struct list_node *node);
+void list_fingerprint_on_pop_back(struct list_fingerprint *fingerprint, struct list_node *node);
+void list_fingerprint_on_remove(struct list_fingerprint *fingerprint, const struct list_node *first, struct list_node *node, size_t position);
+void list_fingerprint_on_set(struct list_fingerprint *fingerprint, struct list_node *node, size_t position, int old_value);
+void list_fingerprint_clear(struct list_fingerprint *fingerprint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIST_FINGERPRINT_H
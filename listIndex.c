@@ -0,0 +1,390 @@
+#include "listIndex.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashTable.h"
+
+#define LIST_INDEX_MIN_BITS 4
+#define LIST_INDEX_MIN_SHIFTS 8
+
+/*
+ * One entry per distinct value, node is NULL for an empty slot (first, for
+ * the hash table)
+ */
+struct list_index_entry {
+  struct list_node *node; // first occurrence
+  long long key;          // position of the first occurrence is key - origin
+  size_t count;           // number of occurrences
+  size_t shifts;          // number of pending shifts already applied to key
+  int value;
+};
+
+/*
+ * In the log, keys at or after key move by delta. In the steps, delta is
+ * the total move of the keys from key to the next step.
+ */
+struct list_index_shift {
+  long long key;
+  long long delta;
+};
+
+/*
+ * The entries are in a hash table keyed by value. Positions are stored
+ * relative to origin, so that push_front and pop_front shift all of them
+ * in O(1).
+ *
+ * An insertion or a removal in the middle only logs a shift. The entries
+ * untouched since the last flush read their move in the steps, the
+ * composition of the whole log kept sorted by key, with a binary search.
+ * The other ones apply the shifts logged after them one by one. The log is
+ * applied to the whole table when full.
+ */
+struct list_index {
+  struct hash_table table;
+  size_t size; // number of nodes in the list
+  long long origin;
+  struct list_index_shift *shifts;
+  struct list_index_shift *steps;
+  size_t shift_count;
+  size_t step_count;
+  size_t shift_capacity; // about the square root of the table capacity
+  bool valid; // false once growing the table failed, until the next rebuild
+};
+
+/*
+ * Total move of a key untouched since the last flush
+ */
+static long long index_step_delta(const struct list_index *index, long long key) {
+  size_t low = 0;
+  size_t high = index->step_count;
+  while(low < high){
+    size_t middle = low + (high - low) / 2;
+    if(index->steps[middle].key <= key){
+      low = middle + 1;
+    }
+    else{
+      high = middle;
+    }
+  }
+  return low == 0 ? 0 : index->steps[low - 1].delta;
+}
+
+/*
+ * Apply the pending shifts the entry has not seen yet
+ */
+static void index_settle(const struct list_index *index, struct list_index_entry *entry) {
+  if(entry->shifts == 0){
+    entry->key += index_step_delta(index, entry->key);
+  }
+  else{
+    for(size_t i=entry->shifts; i<index->shift_count; ++i){
+      if(entry->key >= index->shifts[i].key){
+        entry->key += index->shifts[i].delta;
+      }
+    }
+  }
+  entry->shifts = index->shift_count;
+}
+
+static void index_settle_all(struct list_index *index) {
+  size_t capacity = hash_table_capacity(&index->table);
+  for(size_t i=0; i<capacity; ++i){
+    struct list_index_entry *entry = hash_table_at(&index->table, i);
+    if(entry->node != NULL){
+      index_settle(index, entry);
+      entry->shifts = 0;
+    }
+  }
+  index->shift_count = 0;
+  index->step_count = 0;
+}
+
+static size_t index_position(const struct list_index *index, struct list_index_entry *entry) {
+  index_settle(index, entry);
+  return (size_t)(entry->key - index->origin);
+}
+
+static struct list_index_entry *index_lookup(const struct list_index *index, int value) {
+  return hash_table_find(&index->table, value);
+}
+
+/*
+ * Size the shift log to the table, about the square root of its capacity.
+ * The index keeps working with the old log if the allocation failed.
+ */
+static bool index_resize_shifts(struct list_index *index) {
+  size_t shift_capacity = (size_t)1 << (index->table.bits / 2);
+  if(shift_capacity < LIST_INDEX_MIN_SHIFTS){
+    shift_capacity = LIST_INDEX_MIN_SHIFTS;
+  }
+  if(shift_capacity == index->shift_capacity) return true;
+  struct list_index_shift *shifts = malloc(2 * shift_capacity * sizeof(struct list_index_shift));
+  if(shifts == NULL) return false;
+  if(index->shifts != NULL){
+    index_settle_all(index);
+  }
+  free(index->shifts);
+  index->shifts = shifts;
+  index->steps = shifts + shift_capacity;
+  index->shift_count = 0;
+  index->step_count = 0;
+  index->shift_capacity = shift_capacity;
+  return true;
+}
+
+static void index_add(struct list_index *index, struct list_node *node, size_t position) {
+  unsigned bits = index->table.bits;
+  struct list_index_entry *entry = hash_table_insert(&index->table, node->data);
+  if(entry == NULL){
+    // the positions are now out of date, list_search walks the list until a rebuild
+    index->valid = false;
+    return;
+  }
+  entry->node = node;
+  entry->key = index->origin + (long long)position;
+  entry->count = 1;
+  entry->shifts = index->shift_count;
+  entry->value = node->data;
+  if(index->table.bits != bits){
+    index_resize_shifts(index);
+  }
+}
+
+/*
+ * The first occurrence was removed, find the next one from a node at a position
+ */
+static void index_rescan(struct list_index *index, struct list_index_entry *entry, struct list_node *from, size_t position) {
+  for(struct list_node *curr = from; curr != NULL; curr = curr->next){
+    if(curr->data == entry->value){
+      entry->node = curr;
+      entry->key = index->origin + (long long)position;
+      entry->shifts = index->shift_count;
+      return;
+    }
+    ++position;
+  }
+  assert(false);
+}
+
+/*
+ * Add delta to the positions at or after position, lazily
+ */
+static void index_shift(struct list_index *index, size_t position, long long delta) {
+  if(index->shift_count == index->shift_capacity){
+    index_settle_all(index);
+  }
+  long long key = index->origin + (long long)position;
+  index->shifts[index->shift_count].key = key;
+  index->shifts[index->shift_count].delta = delta;
+  ++index->shift_count;
+
+  // the untouched keys moved at or after key are the ones from the first
+  // one mapped there, the steps are nondecreasing
+  size_t i = 0;
+  long long first = LLONG_MIN;
+  long long moved = 0;
+  for(;;){
+    long long candidate = key - moved;
+    if(candidate < first){
+      candidate = first;
+    }
+    if(i == index->step_count || candidate < index->steps[i].key){
+      first = candidate;
+      break;
+    }
+    first = index->steps[i].key;
+    moved = index->steps[i].delta;
+    ++i;
+  }
+  if(i == 0 || index->steps[i - 1].key != first){
+    memmove(&index->steps[i + 1], &index->steps[i], (index->step_count - i) * sizeof(struct list_index_shift));
+    index->steps[i].key = first;
+    index->steps[i].delta = moved;
+    ++index->step_count;
+  }
+  else{
+    --i;
+  }
+  for(; i<index->step_count; ++i){
+    index->steps[i].delta += delta;
+  }
+}
+
+/*
+ * A node leaves the list, its successor is now at position
+ */
+static void index_forget(struct list_index *index, struct list_node *node, size_t position) {
+  struct list_index_entry *entry = index_lookup(index, node->data);
+  assert(entry != NULL);
+  if(--entry->count == 0){
+    hash_table_remove(&index->table, entry);
+  }
+  else if(entry->node == node){
+    index_rescan(index, entry, node->next, position);
+  }
+}
+
+/*
+ * A node enters the list at position, the other positions are already shifted
+ */
+static void index_learn(struct list_index *index, struct list_node *node, size_t position) {
+  struct list_index_entry *entry = index_lookup(index, node->data);
+  if(entry == NULL){
+    index_add(index, node, position);
+  }
+  else{
+    ++entry->count;
+    if(index_position(index, entry) > position){
+      entry->node = node;
+      entry->key = index->origin + (long long)position;
+      entry->shifts = index->shift_count;
+    }
+  }
+}
+
+bool list_index_attach(struct list *self) {
+  if(self->index != NULL) return true;
+  struct list_index *index = malloc(sizeof(struct list_index));
+  if(index == NULL) return false;
+  index->shifts = NULL;
+  index->steps = NULL;
+  index->shift_capacity = 0;
+  index->size = 0;
+  index->origin = 0;
+  index->valid = true;
+  if(!hash_table_create(&index->table, sizeof(struct list_index_entry), offsetof(struct list_index_entry, value), LIST_INDEX_MIN_BITS)){
+    free(index);
+    return false;
+  }
+  if(!index_resize_shifts(index)){
+    hash_table_destroy(&index->table);
+    free(index);
+    return false;
+  }
+  self->index = index;
+  list_index_rebuild(self);
+  return true;
+}
+
+void list_index_detach(struct list *self) {
+  if(self->index == NULL) return;
+  hash_table_destroy(&self->index->table);
+  free(self->index->shifts);
+  free(self->index);
+  self->index = NULL;
+}
+
+void list_index_rebuild(struct list *self) {
+  struct list_index *index = self->index;
+  if(index == NULL) return;
+  list_index_clear(index);
+  for(struct list_node *curr = self->first; curr != NULL; curr = curr->next){
+    list_index_on_push_back(index, curr);
+  }
+}
+
+bool list_index_usable(const struct list *self) {
+  return self->index != NULL && self->index->valid;
+}
+
+bool list_index_find(const struct list *self, int value, size_t *position, struct list_node **node) {
+  if(!list_index_usable(self)) return false;
+  struct list_index_entry *entry = index_lookup(self->index, value);
+  if(entry == NULL){
+    if(position != NULL){
+      *position = self->index->size;
+    }
+    return false;
+  }
+  if(position != NULL){
+    *position = index_position(self->index, entry);
+  }
+  if(node != NULL){
+    *node = entry->node;
+  }
+  return true;
+}
+
+size_t list_index_memory(const struct list *self) {
+  if(self->index == NULL) return 0;
+  return sizeof(struct list_index) + hash_table_capacity(&self->index->table) * sizeof(struct list_index_entry)
+    + 2 * self->index->shift_capacity * sizeof(struct list_index_shift);
+}
+
+void list_index_on_push_front(struct list_index *index, struct list_node *node) {
+  if(!index->valid) return;
+  --index->origin;
+  ++index->size;
+  index_learn(index, node, 0);
+}
+
+void list_index_on_push_back(struct list_index *index, struct list_node *node) {
+  if(!index->valid) return;
+  index_learn(index, node, index->size);
+  ++index->size;
+}
+
+void list_index_on_insert(struct list_index *index, struct list_node *node, size_t position) {
+  if(!index->valid) return;
+  if(position == 0){
+    list_index_on_push_front(index, node);
+    return;
+  }
+  if(position == index->size){
+    list_index_on_push_back(index, node);
+    return;
+  }
+  index_shift(index, position, 1);
+  ++index->size;
+  index_learn(index, node, position);
+}
+
+void list_index_on_pop_front(struct list_index *index, struct list_node *node) {
+  if(!index->valid) return;
+  ++index->origin;
+  --index->size;
+  index_forget(index, node, 0);
+}
+
+void list_index_on_pop_back(struct list_index *index, struct list_node *node) {
+  if(!index->valid) return;
+  --index->size;
+  // the last node is never the first occurrence of a duplicated value
+  index_forget(index, node, index->size);
+}
+
+void list_index_on_remove(struct list_index *index, struct list_node *node, size_t position) {
+  if(!index->valid) return;
+  if(position == 0){
+    list_index_on_pop_front(index, node);
+    return;
+  }
+  index_shift(index, position + 1, -1);
+  --index->size;
+  index_forget(index, node, position);
+}
+
+void list_index_on_set(struct list_index *index, struct list_node *node, size_t position, int old_value) {
+  if(!index->valid || old_value == node->data) return;
+  struct list_index_entry *entry = index_lookup(index, old_value);
+  assert(entry != NULL);
+  if(--entry->count == 0){
+    hash_table_remove(&index->table, entry);
+  }
+  else if(entry->node == node){
+    index_rescan(index, entry, node->next, position + 1);
+  }
+  index_learn(index, node, position);
+}
+
+void list_index_clear(struct list_index *index) {
+  hash_table_clear(&index->table);
+  index->size = 0;
+  index->origin = 0;
+  index->shift_count = 0;
+  index->step_count = 0;
+  index->valid = true;
+}
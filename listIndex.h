@@ -0,0 +1,79 @@
+#ifndef LIST_INDEX_H
+#define LIST_INDEX_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Optional hash index of a list: for each value, the position and the node
+ * of its first occurrence. Once attached, it is kept up to date by the
+ * functions of linkedList.h and list_search uses it. Code linking nodes or
+ * writing values by hand must call list_relinked afterwards.
+ *
+ * push_front, push_back, pop_back and set of a value are O(1). insert and
+ * remove log the shift of the positions after them, in O(sqrt(capacity))
+ * amortized on top of the walk to the position, and a lookup applies the
+ * shifts its entry has not seen yet, in O(sqrt(capacity)) at worst. Removing the first occurrence
+ * of a duplicated value rescans the list from there to find the next one.
+ *
+ * If the table cannot grow, the index stops following the list and
+ * list_search falls back to a walk until list_index_rebuild.
+ */
+struct list_index;
+
+/*
+ * Attach an index built from the current content of the list, return false if the allocation failed
+ */
+bool list_index_attach(struct list *self);
+
+/*
+ * Detach and free the index of a list, if any
+ */
+void list_index_detach(struct list *self);
+
+/*
+ * Rebuild the index from the content of the list, if any
+ */
+void list_index_rebuild(struct list *self);
+
+/*
+ * Tell if the list has an index that is up to date
+ */
+bool list_index_usable(const struct list *self);
+
+/*
+ * Look for the first occurrence of a value, return false if not present or
+ * if the list has no usable index. position and node can be NULL. When the value is
+ * not present in an indexed list, position is set to the size of the list.
+ */
+bool list_index_find(const struct list *self, int value, size_t *position, struct list_node **node);
+
+/*
+ * Get the memory used by the index in bytes
+ */
+size_t list_index_memory(const struct list *self);
+
+/*
+ * Maintenance, called by linkedList.c after the list has been relinked.
+ * A removed node is still readable during the call.
+ */
+void list_index_on_push_front(struct list_index *index, struct list_node *node);
+void list_index_on_push_back(struct list_index *index, struct list_node *node);
+void list_index_on_insert(struct list_index *index, struct list_node *node, size_t position);
+void list_index_on_pop_front(struct list_index *index, struct list_node *node);
+void list_index_on_pop_back(struct list_index *index, struct list_node *node);
+void list_index_on_remove(struct list_index *index, struct list_node *node, size_t position);
+void list_index_on_set(struct list_index *index, struct list_node *node, size_t position, int old_value);
+void list_index_clear(struct list_index *index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIST_INDEX_H
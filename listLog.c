@@ -0,0 +1,699 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // ftruncate, fsync, fdatasync, strdup with -std=c11
+#endif
+
+#include "listLog.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Durability primitives: POSIX, with fdatasync on Linux only, and the
+ * Windows (MinGW) equivalents. Windows has no directory fsync, the rename
+ * is made durable by MOVEFILE_WRITE_THROUGH instead.
+ */
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#define LOG_OPEN_FLAGS O_BINARY
+static int log_fsync(int fd) { return _commit(fd); }
+static int log_fdatasync(int fd) { return _commit(fd); }
+static bool log_rename(const char *from, const char *to) {
+  return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+#else
+#define LOG_OPEN_FLAGS 0
+static int log_fsync(int fd) { return fsync(fd); }
+#if defined(__linux__)
+static int log_fdatasync(int fd) { return fdatasync(fd); }
+#else
+static int log_fdatasync(int fd) { return fsync(fd); }
+#endif
+static bool log_rename(const char *from, const char *to) { return rename(from, to) == 0; }
+#endif
+
+/*
+ * Log file:        magic, generation (u64), then frames
+ * Frame:           payload size (u32), CRC of the payload (u32), records
+ * Record:          opcode (u8), then its operands as varints
+ * Checkpoint file: magic, generation (u64), size (varint), values (varints), CRC of everything before (u32)
+ *
+ * Integers are little endian, indexes are unsigned LEB128 varints and
+ * values are zigzag encoded first. The checkpoint of generation g contains
+ * everything logged before generation g, so a log whose generation is
+ * older than the checkpoint (crash between the rename of the checkpoint
+ * and the reset of the log) is ignored.
+ */
+
+#define LOG_MAGIC "LLOG"
+#define CHECKPOINT_MAGIC "LCKP"
+#define LOG_HEADER_SIZE 12
+#define FRAME_HEADER_SIZE 8
+#define VARINT_MAX_SIZE 10
+
+enum log_opcode {
+  LOG_PUSH_FRONT = 1,
+  LOG_POP_FRONT,
+  LOG_PUSH_BACK,
+  LOG_POP_BACK,
+  LOG_INSERT,
+  LOG_REMOVE,
+  LOG_SET,
+  LOG_MERGE_SORT,
+  LOG_CLEAR,
+};
+
+struct list_log {
+  struct list *list;
+  int fd;
+  char *path;
+  uint64_t generation;
+  size_t size; // of the log file
+  size_t batch;
+  size_t pending; // records in the buffer
+  size_t length;  // bytes in the buffer, after the room for the frame header
+  size_t capacity;
+  unsigned char *buffer;
+  bool failed;
+};
+
+/*
+ * CRC-32 (IEEE), table built once
+ */
+
+static uint32_t crc_table[256];
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+static void crc_init(void) {
+  for(uint32_t i=0; i<256; ++i){
+    uint32_t crc = i;
+    for(int bit=0; bit<8; ++bit){
+      crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320u : crc >> 1;
+    }
+    crc_table[i] = crc;
+  }
+}
+
+static uint32_t crc32(const unsigned char *data, size_t size) {
+  pthread_once(&crc_once, crc_init);
+  uint32_t crc = 0xffffffffu;
+  for(size_t i=0; i<size; ++i){
+    crc = crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc ^ 0xffffffffu;
+}
+
+/*
+ * Encoding
+ */
+
+static void put_u32(unsigned char *out, uint32_t value) {
+  for(int i=0; i<4; ++i){
+    out[i] = (unsigned char)(value >> (8 * i));
+  }
+}
+
+static void put_u64(unsigned char *out, uint64_t value) {
+  for(int i=0; i<8; ++i){
+    out[i] = (unsigned char)(value >> (8 * i));
+  }
+}
+
+static uint32_t get_u32(const unsigned char *in) {
+  uint32_t value = 0;
+  for(int i=0; i<4; ++i){
+    value |= (uint32_t)in[i] << (8 * i);
+  }
+  return value;
+}
+
+static uint64_t get_u64(const unsigned char *in) {
+  uint64_t value = 0;
+  for(int i=0; i<8; ++i){
+    value |= (uint64_t)in[i] << (8 * i);
+  }
+  return value;
+}
+
+static size_t put_varint(unsigned char *out, uint64_t value) {
+  size_t size = 0;
+  while(value >= 0x80){
+    out[size++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  out[size++] = (unsigned char)value;
+  return size;
+}
+
+static uint64_t zigzag(int value) {
+  return ((uint64_t)(int64_t)value << 1) ^ (uint64_t)((int64_t)value >> 63);
+}
+
+static int unzigzag(uint64_t value) {
+  return (int)(int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/*
+ * Bounded reader, any read past the end or malformed varint sets failed
+ */
+struct log_reader {
+  const unsigned char *data;
+  size_t size;
+  size_t offset;
+  bool failed;
+};
+
+static uint64_t read_varint(struct log_reader *in) {
+  uint64_t value = 0;
+  for(unsigned shift = 0; shift < 64; shift += 7){
+    if(in->offset >= in->size) break;
+    unsigned char byte = in->data[in->offset++];
+    value |= (uint64_t)(byte & 0x7f) << shift;
+    if((byte & 0x80) == 0) return value;
+  }
+  in->failed = true;
+  return 0;
+}
+
+static int read_value(struct log_reader *in) {
+  uint64_t value = read_varint(in);
+  if(value > UINT32_MAX){
+    in->failed = true;
+  }
+  return unzigzag(value);
+}
+
+/*
+ * Files
+ */
+
+static bool write_all(int fd, const unsigned char *data, size_t size) {
+  while(size > 0){
+    ssize_t written = write(fd, data, size);
+    if(written < 0){
+      if(errno == EINTR) continue;
+      return false;
+    }
+    data += written;
+    size -= (size_t)written;
+  }
+  return true;
+}
+
+/*
+ * Read a whole file, a missing file is empty
+ */
+static bool read_file(const char *path, unsigned char **data, size_t *size) {
+  *data = NULL;
+  *size = 0;
+  int fd = open(path, O_RDONLY | LOG_OPEN_FLAGS);
+  if(fd < 0) return errno == ENOENT;
+  struct stat st;
+  if(fstat(fd, &st) != 0){
+    close(fd);
+    return false;
+  }
+  *data = malloc((size_t)st.st_size + 1);
+  size_t done = 0;
+  while(*data != NULL && done < (size_t)st.st_size){
+    ssize_t count = read(fd, *data + done, (size_t)st.st_size - done);
+    if(count < 0 && errno == EINTR) continue;
+    if(count <= 0) break;
+    done += (size_t)count;
+  }
+  close(fd);
+  if(*data == NULL || done != (size_t)st.st_size){
+    free(*data);
+    *data = NULL;
+    return false;
+  }
+  *size = done;
+  return true;
+}
+
+/*
+ * fsync the directory of a path, so that a rename or a creation is durable
+ */
+static bool sync_directory(const char *path) {
+#if defined(_WIN32)
+  (void)path;
+  return true;
+#else
+  const char *slash = strrchr(path, '/');
+  size_t size = slash == NULL ? 1 : (slash == path ? 1 : (size_t)(slash - path));
+  char *dir = malloc(size + 1);
+  if(dir == NULL) return false;
+  memcpy(dir, slash == NULL ? "." : path, size);
+  dir[size] = '\0';
+#ifdef O_DIRECTORY
+  int fd = open(dir, O_RDONLY | O_DIRECTORY);
+#else
+  int fd = open(dir, O_RDONLY);
+#endif
+  free(dir);
+  if(fd < 0) return false;
+  bool ok = log_fsync(fd) == 0;
+  close(fd);
+  return ok;
+#endif
+}
+
+static char *path_with_suffix(const char *path, const char *suffix) {
+  size_t size = strlen(path);
+  char *out = malloc(size + strlen(suffix) + 1);
+  if(out == NULL) return NULL;
+  memcpy(out, path, size);
+  strcpy(out + size, suffix);
+  return out;
+}
+
+/*
+ * Empty a list, keeping its allocator and its index
+ */
+static void clear_list(struct list *self) {
+  while(!list_empty(self)){
+    list_pop_front(self);
+  }
+}
+
+/*
+ * Recovery
+ */
+
+static bool load_checkpoint(struct list *self, const char *path, uint64_t *generation) {
+  *generation = 0;
+  char *checkpoint_path = path_with_suffix(path, ".checkpoint");
+  if(checkpoint_path == NULL) return false;
+  unsigned char *data;
+  size_t size;
+  bool ok = read_file(checkpoint_path, &data, &size);
+  free(checkpoint_path);
+  if(!ok) return false;
+  if(data == NULL) return true;
+
+  // the checkpoint is renamed in place complete, a bad one is an error
+  ok = size >= LOG_HEADER_SIZE + 4 && memcmp(data, CHECKPOINT_MAGIC, 4) == 0
+    && get_u32(data + size - 4) == crc32(data, size - 4);
+  if(ok){
+    *generation = get_u64(data + 4);
+    struct log_reader in = { data, size - 4, LOG_HEADER_SIZE, false };
+    uint64_t count = read_varint(&in);
+    struct list_node **link = &self->first;
+    for(uint64_t i=0; i<count && !in.failed; ++i){
+      struct list_node *node = list_node_create(self, read_value(&in));
+      *link = node;
+      link = &node->next;
+    }
+    ok = !in.failed && in.offset == in.size;
+    list_relinked(self);
+  }
+  free(data);
+  return ok;
+}
+
+/*
+ * A decoded record, index and value are set when the opcode has them
+ */
+struct log_record {
+  enum log_opcode opcode;
+  int value;
+  size_t index;
+};
+
+/*
+ * Decode a record and check it against the size of the list it will be
+ * applied to, which it updates
+ */
+static bool decode_record(struct log_reader *in, struct log_record *record, size_t *size) {
+  record->opcode = (enum log_opcode)in->data[in->offset++];
+  record->value = 0;
+  record->index = 0;
+  switch(record->opcode){
+  case LOG_PUSH_FRONT:
+  case LOG_PUSH_BACK:
+    record->value = read_value(in);
+    ++*size;
+    break;
+  case LOG_POP_FRONT:
+  case LOG_POP_BACK:
+    if(*size > 0) --*size;
+    break;
+  case LOG_INSERT: {
+    record->value = read_value(in);
+    uint64_t index = read_varint(in);
+    if(in->failed || index > *size) return false;
+    record->index = (size_t)index;
+    ++*size;
+    break;
+  }
+  case LOG_REMOVE: {
+    uint64_t index = read_varint(in);
+    if(in->failed || index >= *size) return false;
+    record->index = (size_t)index;
+    --*size;
+    break;
+  }
+  case LOG_SET: {
+    uint64_t index = read_varint(in);
+    record->value = read_value(in);
+    if(in->failed) return false;
+    record->index = (size_t)index; // out of range is a no-op, as for list_set
+    break;
+  }
+  case LOG_MERGE_SORT:
+    break;
+  case LOG_CLEAR:
+    *size = 0;
+    break;
+  default:
+    return false;
+  }
+  return !in->failed;
+}
+
+static void apply_record(struct list *self, const struct log_record *record) {
+  switch(record->opcode){
+  case LOG_PUSH_FRONT:
+    list_push_front(self, record->value);
+    break;
+  case LOG_POP_FRONT:
+    list_pop_front(self);
+    break;
+  case LOG_PUSH_BACK:
+    list_push_back(self, record->value);
+    break;
+  case LOG_POP_BACK:
+    list_pop_back(self);
+    break;
+  case LOG_INSERT:
+    list_insert(self, record->value, record->index);
+    break;
+  case LOG_REMOVE:
+    list_remove(self, record->index);
+    break;
+  case LOG_SET:
+    list_set(self, record->index, record->value);
+    break;
+  case LOG_MERGE_SORT:
+    list_merge_sort(self);
+    break;
+  case LOG_CLEAR:
+    clear_list(self);
+    break;
+  }
+}
+
+/*
+ * Replay the complete frames of the log and store the size of the valid
+ * prefix of the file in valid. A frame is applied only once its CRC
+ * matched and all its records decoded and validated, so the list never
+ * holds part of a frame that recovery truncates. Return false if the
+ * scratch records could not be allocated.
+ */
+static bool replay_log(struct list *self, const unsigned char *data, size_t size, size_t *valid) {
+  size_t list_size_now = list_size(self);
+  size_t offset = LOG_HEADER_SIZE;
+  struct log_record *records = NULL;
+  size_t capacity = 0;
+  bool ok = true;
+  while(size - offset >= FRAME_HEADER_SIZE){
+    uint32_t payload = get_u32(data + offset);
+    uint32_t crc = get_u32(data + offset + 4);
+    if(payload > size - offset - FRAME_HEADER_SIZE) break; // torn
+    const unsigned char *frame = data + offset + FRAME_HEADER_SIZE;
+    if(crc32(frame, payload) != crc) break;
+
+    struct log_reader in = { frame, payload, 0, false };
+    size_t count = 0;
+    size_t frame_size = list_size_now;
+    bool decoded = true;
+    while(decoded && in.offset < in.size){
+      if(count == capacity){
+        size_t grown = capacity == 0 ? 64 : 2 * capacity;
+        struct log_record *larger = realloc(records, grown * sizeof(struct log_record));
+        if(larger == NULL){
+          ok = false;
+          break;
+        }
+        records = larger;
+        capacity = grown;
+      }
+      decoded = decode_record(&in, &records[count++], &frame_size);
+    }
+    if(!ok || !decoded) break;
+
+    for(size_t i=0; i<count; ++i){
+      apply_record(self, &records[i]);
+    }
+    list_size_now = frame_size;
+    offset += FRAME_HEADER_SIZE + payload;
+  }
+  free(records);
+  *valid = offset;
+  return ok;
+}
+
+/*
+ * Start an empty log of a generation, in place of the current one
+ */
+static bool log_reset(struct list_log *log, uint64_t generation) {
+  unsigned char header[LOG_HEADER_SIZE];
+  memcpy(header, LOG_MAGIC, 4);
+  put_u64(header + 4, generation);
+  if(ftruncate(log->fd, 0) != 0) return false;
+  if(lseek(log->fd, 0, SEEK_SET) != 0) return false;
+  if(!write_all(log->fd, header, sizeof(header)) || log_fsync(log->fd) != 0) return false;
+  log->generation = generation;
+  log->size = sizeof(header);
+  return true;
+}
+
+struct list_log *list_log_open(struct list *self, const char *path, size_t batch) {
+  assert(list_empty(self));
+  struct list_log *log = calloc(1, sizeof(struct list_log));
+  if(log == NULL) return NULL;
+  log->list = self;
+  log->batch = batch == 0 ? LIST_LOG_DEFAULT_BATCH : batch;
+  log->path = strdup(path);
+  log->capacity = 256;
+  log->buffer = malloc(log->capacity);
+  log->length = FRAME_HEADER_SIZE;
+  log->fd = -1;
+  if(log->path == NULL || log->buffer == NULL) goto fail;
+
+  uint64_t generation;
+  if(!load_checkpoint(self, path, &generation)) goto fail;
+
+  unsigned char *data;
+  size_t size;
+  if(!read_file(path, &data, &size)) goto fail;
+  bool current = data != NULL && size >= LOG_HEADER_SIZE && memcmp(data, LOG_MAGIC, 4) == 0
+    && get_u64(data + 4) == generation;
+  size_t valid = 0;
+  bool replayed = !current || replay_log(self, data, size, &valid);
+  free(data);
+  if(!replayed) goto fail;
+
+  log->fd = open(path, O_RDWR | O_CREAT | LOG_OPEN_FLAGS, 0644);
+  if(log->fd < 0) goto fail;
+  if(current){
+    // drop the torn tail, the next frames are appended after the valid ones
+    if(valid < size && (ftruncate(log->fd, (off_t)valid) != 0 || log_fsync(log->fd) != 0)) goto fail;
+    if(lseek(log->fd, (off_t)valid, SEEK_SET) != (off_t)valid) goto fail;
+    log->generation = generation;
+    log->size = valid;
+  }
+  else{
+    if(!log_reset(log, generation)) goto fail;
+    if(!sync_directory(path)) goto fail;
+  }
+  return log;
+
+fail:
+  if(log->fd >= 0){
+    close(log->fd);
+  }
+  clear_list(self);
+  free(log->buffer);
+  free(log->path);
+  free(log);
+  return NULL;
+}
+
+/*
+ * Buffering and commit
+ */
+
+static bool log_append(struct list_log *log, const unsigned char *record, size_t size) {
+  if(log->length + size > log->capacity){
+    size_t capacity = 2 * log->capacity;
+    unsigned char *buffer = realloc(log->buffer, capacity);
+    if(buffer == NULL){
+      log->failed = true;
+      return false;
+    }
+    log->buffer = buffer;
+    log->capacity = capacity;
+  }
+  memcpy(log->buffer + log->length, record, size);
+  log->length += size;
+  if(++log->pending >= log->batch){
+    return list_log_commit(log);
+  }
+  return true;
+}
+
+static bool log_record(struct list_log *log, enum log_opcode opcode) {
+  unsigned char record[1] = { (unsigned char)opcode };
+  return log_append(log, record, sizeof(record));
+}
+
+static bool log_record_value(struct list_log *log, enum log_opcode opcode, int value) {
+  unsigned char record[1 + VARINT_MAX_SIZE] = { (unsigned char)opcode };
+  size_t size = 1 + put_varint(record + 1, zigzag(value));
+  return log_append(log, record, size);
+}
+
+static bool log_record_index(struct list_log *log, enum log_opcode opcode, size_t index) {
+  unsigned char record[1 + VARINT_MAX_SIZE] = { (unsigned char)opcode };
+  size_t size = 1 + put_varint(record + 1, index);
+  return log_append(log, record, size);
+}
+
+bool list_log_commit(struct list_log *log) {
+  if(log->failed) return false;
+  if(log->pending == 0) return true;
+  size_t payload = log->length - FRAME_HEADER_SIZE;
+  put_u32(log->buffer, (uint32_t)payload);
+  put_u32(log->buffer + 4, crc32(log->buffer + FRAME_HEADER_SIZE, payload));
+  if(!write_all(log->fd, log->buffer, log->length) || log_fdatasync(log->fd) != 0){
+    // the file may end with a torn frame now, recovery drops it
+    log->failed = true;
+    return false;
+  }
+  log->size += log->length;
+  log->length = FRAME_HEADER_SIZE;
+  log->pending = 0;
+  return true;
+}
+
+bool list_log_checkpoint(struct list_log *log) {
+  if(!list_log_commit(log)) return false;
+
+  // header, size, values and CRC, values are at most 5 bytes
+  size_t count = list_size(log->list);
+  size_t capacity = LOG_HEADER_SIZE + VARINT_MAX_SIZE + 5 * count + 4;
+  unsigned char *data = malloc(capacity);
+  if(data == NULL) return false;
+  memcpy(data, CHECKPOINT_MAGIC, 4);
+  put_u64(data + 4, log->generation + 1);
+  size_t size = LOG_HEADER_SIZE;
+  size += put_varint(data + size, count);
+  for(struct list_node *curr = log->list->first; curr != NULL; curr = curr->next){
+    size += put_varint(data + size, zigzag(curr->data));
+  }
+  put_u32(data + size, crc32(data, size));
+  size += 4;
+
+  char *checkpoint_path = path_with_suffix(log->path, ".checkpoint");
+  char *tmp_path = path_with_suffix(log->path, ".checkpoint.tmp");
+  bool ok = checkpoint_path != NULL && tmp_path != NULL;
+  if(ok){
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | LOG_OPEN_FLAGS, 0644);
+    ok = fd >= 0;
+    if(ok){
+      ok = write_all(fd, data, size) && log_fsync(fd) == 0;
+      close(fd);
+    }
+    ok = ok && log_rename(tmp_path, checkpoint_path) && sync_directory(log->path);
+    if(!ok && tmp_path != NULL){
+      unlink(tmp_path);
+    }
+  }
+  free(tmp_path);
+  free(checkpoint_path);
+  free(data);
+
+  // once the checkpoint is durable, the log of the old generation is obsolete
+  if(ok && !log_reset(log, log->generation + 1)){
+    log->failed = true;
+    ok = false;
+  }
+  return ok;
+}
+
+bool list_log_close(struct list_log *log) {
+  bool ok = list_log_commit(log);
+  close(log->fd);
+  free(log->buffer);
+  free(log->path);
+  free(log);
+  return ok;
+}
+
+size_t list_log_size(const struct list_log *log) {
+  return log->size;
+}
+
+/*
+ * Mutators
+ */
+
+bool list_log_push_front(struct list_log *log, int value) {
+  list_push_front(log->list, value);
+  return log_record_value(log, LOG_PUSH_FRONT, value);
+}
+
+bool list_log_pop_front(struct list_log *log) {
+  list_pop_front(log->list);
+  return log_record(log, LOG_POP_FRONT);
+}
+
+bool list_log_push_back(struct list_log *log, int value) {
+  list_push_back(log->list, value);
+  return log_record_value(log, LOG_PUSH_BACK, value);
+}
+
+bool list_log_pop_back(struct list_log *log) {
+  list_pop_back(log->list);
+  return log_record(log, LOG_POP_BACK);
+}
+
+bool list_log_insert(struct list_log *log, int value, size_t index) {
+  list_insert(log->list, value, index);
+  unsigned char record[1 + 2 * VARINT_MAX_SIZE] = { LOG_INSERT };
+  size_t size = 1 + put_varint(record + 1, zigzag(value));
+  size += put_varint(record + size, index);
+  return log_append(log, record, size);
+}
+
+bool list_log_remove(struct list_log *log, size_t index) {
+  list_remove(log->list, index);
+  return log_record_index(log, LOG_REMOVE, index);
+}
+
+bool list_log_set(struct list_log *log, size_t index, int value) {
+  list_set(log->list, index, value);
+  unsigned char record[1 + 2 * VARINT_MAX_SIZE] = { LOG_SET };
+  size_t size = 1 + put_varint(record + 1, index);
+  size += put_varint(record + size, zigzag(value));
+  return log_append(log, record, size);
+}
+
+bool list_log_merge_sort(struct list_log *log) {
+  list_merge_sort(log->list);
+  return log_record(log, LOG_MERGE_SORT);
+}
+
+bool list_log_clear(struct list_log *log) {
+  clear_list(log->list);
+  return log_record(log, LOG_CLEAR);
+}
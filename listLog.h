@@ -0,0 +1,77 @@
+#ifndef LIST_LOG_H
+#define LIST_LOG_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIST_LOG_DEFAULT_BATCH 64
+
+/*
+ * Write-ahead log of the mutations of a list. The list is changed through
+ * the list_log_* functions below, which apply the mutation and append a
+ * compact record to a buffer. The buffered records are written as one
+ * frame with a CRC and fsync'ed together (group commit), every batch
+ * records or on list_log_commit. A checkpoint writes the whole list to
+ * <path>.checkpoint (through a temporary file and a rename) and empties
+ * the log, so that recovery only replays what happened since.
+ *
+ * A frame torn by a crash is detected by its length or its CRC: recovery
+ * stops at the last complete frame and the log is truncated there. After
+ * a failed write, the log refuses to commit anything else and the list
+ * has to be recovered again.
+ */
+struct list_log;
+
+/*
+ * Recover an empty list from the checkpoint and the log at path, then open
+ * the log to record its next mutations. Missing files mean an empty list.
+ * Return NULL if the files could not be read or opened.
+ */
+struct list_log *list_log_open(struct list *self, const char *path, size_t batch);
+
+/*
+ * Commit the buffered records and close the log, the list stays as is.
+ * Return false if the last commit failed.
+ */
+bool list_log_close(struct list_log *log);
+
+/*
+ * Write the buffered records and wait for them to be on disk
+ */
+bool list_log_commit(struct list_log *log);
+
+/*
+ * Write the whole list as the new checkpoint and empty the log
+ */
+bool list_log_checkpoint(struct list_log *log);
+
+/*
+ * Get the size of the log file in bytes, buffered records not included
+ */
+size_t list_log_size(const struct list_log *log);
+
+/*
+ * Logged mutators, same contracts as the functions of linkedList.h.
+ * They return false if a commit they triggered failed.
+ */
+bool list_log_push_front(struct list_log *log, int value);
+bool list_log_pop_front(struct list_log *log);
+bool list_log_push_back(struct list_log *log, int value);
+bool list_log_pop_back(struct list_log *log);
+bool list_log_insert(struct list_log *log, int value, size_t index);
+bool list_log_remove(struct list_log *log, size_t index);
+bool list_log_set(struct list_log *log, size_t index, int value);
+bool list_log_merge_sort(struct list_log *log);
+bool list_log_clear(struct list_log *log);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIST_LOG_H
@@ -0,0 +1,177 @@
+#include "listQueue.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "listAtomic.h"
+
+static struct list_node **list_tail_link(struct list *out) {
+  struct list_node **link = &out->first;
+  while(*link != NULL){
+    link = &(*link)->next;
+  }
+  return link;
+}
+
+void list_mpsc_create(struct list_mpsc_queue *self) {
+  self->stub.data = 0;
+  self->stub.next = NULL;
+  self->head = &self->stub;
+  self->tail = &self->stub;
+}
+
+void list_mpsc_destroy(struct list_mpsc_queue *self, struct list *out) {
+  if(out != NULL){
+    list_mpsc_pop_batch(self, out, SIZE_MAX);
+  }
+}
+
+void list_mpsc_push_chain(struct list_mpsc_queue *self, struct list_node *first, struct list_node *last) {
+  last->next = NULL;
+  struct list_node *prev = __atomic_exchange_n(&self->head, last, __ATOMIC_ACQ_REL);
+  // the chain is unreachable for the consumer until this store
+  STORE_RELEASE(&prev->next, first);
+}
+
+void list_mpsc_push(struct list_mpsc_queue *self, struct list_node *node) {
+  list_mpsc_push_chain(self, node, node);
+}
+
+struct list_node *list_mpsc_pop(struct list_mpsc_queue *self) {
+  struct list_node *tail = self->tail;
+  struct list_node *next = LOAD_ACQUIRE(&tail->next);
+  if(tail == &self->stub){
+    if(next == NULL) return NULL;
+    self->tail = next;
+    tail = next;
+    next = LOAD_ACQUIRE(&tail->next);
+  }
+  if(next != NULL){
+    self->tail = next;
+    tail->next = NULL;
+    return tail;
+  }
+  if(tail != LOAD_ACQUIRE(&self->head)){
+    return NULL; // a producer is between its exchange and its store
+  }
+  list_mpsc_push(self, &self->stub);
+  next = LOAD_ACQUIRE(&tail->next);
+  if(next != NULL){
+    self->tail = next;
+    tail->next = NULL;
+    return tail;
+  }
+  return NULL;
+}
+
+size_t list_mpsc_pop_batch(struct list_mpsc_queue *self, struct list *out, size_t max) {
+  struct list_node **link = list_tail_link(out);
+  size_t count = 0;
+  struct list_node *node;
+  while(count < max && (node = list_mpsc_pop(self)) != NULL){
+    *link = node;
+    link = &node->next;
+    list_node_appended(out, node);
+    ++count;
+  }
+  return count;
+}
+
+bool list_spsc_create(struct list_spsc_queue *self, size_t capacity) {
+  size_t size = 1;
+  while(size < capacity){
+    size <<= 1;
+  }
+  self->slots = malloc(size * sizeof(struct list_node *));
+  if(self->slots == NULL) return false;
+  self->mask = size - 1;
+  self->head = 0;
+  self->tail = 0;
+  self->cached_head = 0;
+  self->cached_tail = 0;
+  return true;
+}
+
+void list_spsc_destroy(struct list_spsc_queue *self, struct list *out) {
+  if(out != NULL){
+    list_spsc_pop_batch(self, out, SIZE_MAX);
+  }
+  free(self->slots);
+  self->slots = NULL;
+}
+
+/*
+ * Room left for the producer, the consumer index is only reloaded when the
+ * cached one gives less than wanted. With wanted at 1, it is reloaded only
+ * when the queue looks full.
+ */
+static size_t list_spsc_room(struct list_spsc_queue *self, size_t wanted) {
+  size_t capacity = self->mask + 1;
+  if(capacity - (self->tail - self->cached_head) < wanted){
+    self->cached_head = LOAD_ACQUIRE(&self->head);
+  }
+  return capacity - (self->tail - self->cached_head);
+}
+
+/*
+ * Same for the consumer, with the producer index
+ */
+static size_t list_spsc_available(struct list_spsc_queue *self, size_t wanted) {
+  if(self->cached_tail - self->head < wanted){
+    self->cached_tail = LOAD_ACQUIRE(&self->tail);
+  }
+  return self->cached_tail - self->head;
+}
+
+bool list_spsc_push(struct list_spsc_queue *self, struct list_node *node) {
+  if(list_spsc_room(self, 1) == 0) return false;
+  size_t tail = self->tail;
+  self->slots[tail & self->mask] = node;
+  STORE_RELEASE(&self->tail, tail + 1);
+  return true;
+}
+
+size_t list_spsc_push_chain(struct list_spsc_queue *self, struct list_node **first) {
+  // the length of the chain is unknown, ask for as much as the queue can hold
+  size_t room = list_spsc_room(self, self->mask + 1);
+  size_t tail = self->tail;
+  size_t count = 0;
+  struct list_node *curr = *first;
+  while(count < room && curr != NULL){
+    struct list_node *next = curr->next;
+    curr->next = NULL;
+    self->slots[(tail + count) & self->mask] = curr;
+    curr = next;
+    ++count;
+  }
+  STORE_RELEASE(&self->tail, tail + count);
+  *first = curr;
+  return count;
+}
+
+struct list_node *list_spsc_pop(struct list_spsc_queue *self) {
+  if(list_spsc_available(self, 1) == 0) return NULL;
+  size_t head = self->head;
+  struct list_node *node = self->slots[head & self->mask];
+  STORE_RELEASE(&self->head, head + 1);
+  return node;
+}
+
+size_t list_spsc_pop_batch(struct list_spsc_queue *self, struct list *out, size_t max) {
+  size_t count = list_spsc_available(self, max);
+  if(count > max){
+    count = max;
+  }
+  struct list_node **link = list_tail_link(out);
+  size_t head = self->head;
+  for(size_t i=0; i<count; ++i){
+    struct list_node *node = self->slots[(head + i) & self->mask];
+    *link = node;
+    link = &node->next;
+    list_node_appended(out, node);
+  }
+  *link = NULL;
+  STORE_RELEASE(&self->head, head + count);
+  return count;
+}
@@ -0,0 +1,111 @@
+#ifndef LIST_QUEUE_H
+#define LIST_QUEUE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIST_QUEUE_CACHE_LINE 64
+
+/*
+ * Unbounded multi-producer single-consumer queue (Vyukov intrusive queue).
+ * Nodes are provided by the producers and given back to the consumer,
+ * nothing is allocated by the queue.
+ */
+struct list_mpsc_queue {
+  struct list_node *head; // last enqueued node, shared by the producers
+  char pad1[LIST_QUEUE_CACHE_LINE - sizeof(struct list_node *)];
+  struct list_node *tail; // next node to dequeue, owned by the consumer
+  char pad2[LIST_QUEUE_CACHE_LINE - sizeof(struct list_node *)];
+  struct list_node stub;
+};
+
+/*
+ * Bounded single-producer single-consumer queue of nodes (ring buffer).
+ */
+struct list_spsc_queue {
+  struct list_node **slots;
+  size_t mask;
+  char pad1[LIST_QUEUE_CACHE_LINE - sizeof(struct list_node **) - sizeof(size_t)];
+  size_t tail; // written by the producer
+  size_t cached_head;
+  char pad2[LIST_QUEUE_CACHE_LINE - 2 * sizeof(size_t)];
+  size_t head; // written by the consumer
+  size_t cached_tail;
+  char pad3[LIST_QUEUE_CACHE_LINE - 2 * sizeof(size_t)];
+};
+
+/*
+ * Create an empty MPSC queue
+ */
+void list_mpsc_create(struct list_mpsc_queue *self);
+
+/*
+ * Destroy a MPSC queue. The remaining nodes are given back at the end of
+ * out, to be released with its allocator, or left alone if out is NULL.
+ */
+void list_mpsc_destroy(struct list_mpsc_queue *self, struct list *out);
+
+/*
+ * Enqueue a node (any producer thread)
+ */
+void list_mpsc_push(struct list_mpsc_queue *self, struct list_node *node);
+
+/*
+ * Enqueue a whole chain of nodes from first to last with a single atomic exchange (any producer thread)
+ */
+void list_mpsc_push_chain(struct list_mpsc_queue *self, struct list_node *first, struct list_node *last);
+
+/*
+ * Dequeue a node (consumer thread only). Return NULL if the queue is empty
+ * or if a producer has not finished linking its node yet.
+ */
+struct list_node *list_mpsc_pop(struct list_mpsc_queue *self);
+
+/*
+ * Dequeue at most max nodes and append them at the end of out, return the number of nodes (consumer thread only)
+ */
+size_t list_mpsc_pop_batch(struct list_mpsc_queue *self, struct list *out, size_t max);
+
+/*
+ * Create an empty SPSC queue holding at least capacity nodes, return false if the allocation failed
+ */
+bool list_spsc_create(struct list_spsc_queue *self, size_t capacity);
+
+/*
+ * Destroy a SPSC queue, the remaining nodes are handled as by list_mpsc_destroy
+ */
+void list_spsc_destroy(struct list_spsc_queue *self, struct list *out);
+
+/*
+ * Enqueue a node, return false if the queue is full (producer thread only)
+ */
+bool list_spsc_push(struct list_spsc_queue *self, struct list_node *node);
+
+/*
+ * Enqueue as many nodes of the chain starting at *first as possible and
+ * publish them at once. *first is advanced to the first node not enqueued.
+ * Return the number of nodes enqueued (producer thread only).
+ */
+size_t list_spsc_push_chain(struct list_spsc_queue *self, struct list_node **first);
+
+/*
+ * Dequeue a node, return NULL if the queue is empty (consumer thread only)
+ */
+struct list_node *list_spsc_pop(struct list_spsc_queue *self);
+
+/*
+ * Dequeue at most max nodes and append them at the end of out, return the number of nodes (consumer thread only)
+ */
+size_t list_spsc_pop_batch(struct list_spsc_queue *self, struct list *out, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIST_QUEUE_H
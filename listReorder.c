@@ -0,0 +1,148 @@
+#include "listReorder.h"
+
+void list_reverse(struct list *self) {
+  struct list_node *reversed = NULL;
+  struct list_node *curr = self->first;
+  while(curr != NULL){
+    struct list_node *next = curr->next;
+    curr->next = reversed;
+    reversed = curr;
+    curr = next;
+  }
+  self->first = reversed;
+  list_relinked(self);
+}
+
+void list_rotate(struct list *self, size_t k) {
+  if(self->first == NULL) return;
+  size_t size = 1;
+  struct list_node *last = self->first;
+  while(last->next != NULL){
+    last = last->next;
+    ++size;
+  }
+  k %= size;
+  if(k == 0) return;
+
+  struct list_node *new_last = self->first;
+  for(size_t i=1; i<k; ++i){
+    new_last = new_last->next;
+  }
+  last->next = self->first;
+  self->first = new_last->next;
+  new_last->next = NULL;
+  list_relinked(self);
+}
+
+size_t list_stable_partition(struct list *self, list_value_predicate predicate, void *ctx) {
+  struct list_node *kept = NULL;
+  struct list_node **kept_link = &kept;
+  struct list_node *others = NULL;
+  struct list_node **others_link = &others;
+  size_t count = 0;
+  for(struct list_node *curr = self->first; curr != NULL; curr = curr->next){
+    if(predicate(curr->data, ctx)){
+      *kept_link = curr;
+      kept_link = &curr->next;
+      ++count;
+    }
+    else{
+      *others_link = curr;
+      others_link = &curr->next;
+    }
+  }
+  *others_link = NULL;
+  *kept_link = others;
+  self->first = kept;
+  list_relinked(self);
+  return count;
+}
+
+/*
+ * xorshift64*, seeded with splitmix64 so that any seed gives a non zero state
+ */
+static uint64_t shuffle_seed(uint64_t seed) {
+  uint64_t z = seed + 0x9e3779b97f4a7c15u;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+  z ^= z >> 31;
+  return z != 0 ? z : 1;
+}
+
+static uint64_t shuffle_next(uint64_t *state) {
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 0x2545f4914f6cdd1du;
+}
+
+/*
+ * Uniform in [0, bound) by multiplication, the rare biased products are
+ * rejected and the division only happens then (Lemire). Ranges too big for
+ * 32 bits fall back to rejection and modulo.
+ */
+static uint64_t shuffle_bounded(uint64_t *state, uint64_t bound) {
+  if(bound > UINT32_MAX){
+    uint64_t threshold = -bound % bound;
+    for(;;){
+      uint64_t r = shuffle_next(state);
+      if(r >= threshold) return r % bound;
+    }
+  }
+  uint64_t product = (shuffle_next(state) >> 32) * bound;
+  uint32_t low = (uint32_t)product;
+  if(low < bound){
+    uint32_t threshold = (uint32_t)-bound % (uint32_t)bound;
+    while(low < threshold){
+      product = (shuffle_next(state) >> 32) * bound;
+      low = (uint32_t)product;
+    }
+  }
+  return product >> 32;
+}
+
+/*
+ * Shuffle size nodes from first, return the chain whose last node is linked
+ * to NULL, *rest receives the node after them. The two shuffled halves are
+ * merged by taking the next node of a half with a probability proportional
+ * to its remaining size, which makes every interleaving equally likely.
+ */
+static struct list_node *shuffle_range(struct list_node *first, size_t size, struct list_node **rest, uint64_t *state) {
+  if(size == 1){
+    *rest = first->next;
+    first->next = NULL;
+    return first;
+  }
+  size_t left_size = size / 2;
+  size_t right_size = size - left_size;
+  struct list_node *middle;
+  struct list_node *left = shuffle_range(first, left_size, &middle, state);
+  struct list_node *right = shuffle_range(middle, right_size, rest, state);
+
+  struct list_node *merged = NULL;
+  struct list_node **link = &merged;
+  while(left_size > 0 && right_size > 0){
+    if(shuffle_bounded(state, left_size + right_size) < left_size){
+      *link = left;
+      left = left->next;
+      --left_size;
+    }
+    else{
+      *link = right;
+      right = right->next;
+      --right_size;
+    }
+    link = &(*link)->next;
+  }
+  *link = left_size > 0 ? left : right;
+  return merged;
+}
+
+void list_shuffle(struct list *self, uint64_t seed) {
+  size_t size = list_size(self);
+  if(size < 2) return;
+  uint64_t state = shuffle_seed(seed);
+  struct list_node *rest;
+  self->first = shuffle_range(self->first, size, &rest, &state);
+  list_relinked(self);
+}
@@ -0,0 +1,46 @@
+#ifndef LIST_REORDER_H
+#define LIST_REORDER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Reordering by relinking the nodes: nothing is allocated or copied, and
+ * the node addresses are preserved.
+ */
+
+/*
+ * Reverse the list, O(n)
+ */
+void list_reverse(struct list *self);
+
+/*
+ * Rotate the list to the left: the element at index k becomes the first
+ * one. k is taken modulo the size of the list, O(n)
+ */
+void list_rotate(struct list *self, size_t k);
+
+/*
+ * Move the elements satisfying the predicate before the others, keeping
+ * the relative order in both groups, and return how many satisfy it. O(n)
+ */
+size_t list_stable_partition(struct list *self, list_value_predicate predicate, void *ctx);
+
+/*
+ * Shuffle the list, every permutation being equally likely for a given
+ * random seed. Merge based, O(n log n) without any allocation.
+ */
+void list_shuffle(struct list *self, uint64_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIST_REORDER_H
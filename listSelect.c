@@ -0,0 +1,181 @@
+#include "listSelect.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "listChain.h"
+
+/*
+ * Pseudo random pivot positions, so that sorted input is not a worst case
+ */
+static size_t select_random(uint64_t *state, size_t bound) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return (size_t)(*state % bound);
+}
+
+static int select_nth(struct list *self, size_t index) {
+  uint64_t state = 0x9e3779b97f4a7c15u;
+  struct list_node **link = &self->first; // link to the first node of the range
+  struct list_node *end = NULL;           // first node after the range
+  size_t size = list_size(self);
+
+  for(;;){
+    if(size == 1) return (*link)->data;
+
+    struct list_node *curr = *link;
+    for(size_t i = select_random(&state, size); i > 0; --i){
+      curr = curr->next;
+    }
+    int pivot = curr->data;
+
+    // three way partition, stable, so that duplicates end the search
+    struct list_chain less = LIST_CHAIN_EMPTY;
+    struct list_chain equal = LIST_CHAIN_EMPTY;
+    struct list_chain greater = LIST_CHAIN_EMPTY;
+    curr = *link;
+    while(curr != end){
+      struct list_node *next = curr->next;
+      if(curr->data < pivot){
+        list_chain_append(&less, curr);
+      }
+      else if(curr->data == pivot){
+        list_chain_append(&equal, curr);
+      }
+      else{
+        list_chain_append(&greater, curr);
+      }
+      curr = next;
+    }
+    struct list_node **tail = list_chain_link(link, &less);
+    tail = list_chain_link(tail, &equal);
+    tail = list_chain_link(tail, &greater);
+    *tail = end;
+
+    if(index < less.size){
+      end = equal.first;
+      size = less.size;
+    }
+    else if(index < less.size + equal.size){
+      return pivot;
+    }
+    else{
+      link = &equal.last->next;
+      index -= less.size + equal.size;
+      size = greater.size;
+    }
+  }
+}
+
+int list_nth_element(struct list *self, size_t index) {
+  int value = select_nth(self, index);
+  list_relinked(self);
+  return value;
+}
+
+/*
+ * Sort size nodes from first by relinking, return the sorted chain whose
+ * last node is linked to NULL, *rest receives the node after them
+ */
+static struct list_node *select_sort(struct list_node *first, size_t size, struct list_node **rest) {
+  if(size == 1){
+    *rest = first->next;
+    first->next = NULL;
+    return first;
+  }
+  struct list_node *middle;
+  struct list_node *left = select_sort(first, size / 2, &middle);
+  struct list_node *right = select_sort(middle, size - size / 2, rest);
+
+  struct list_node *merged = NULL;
+  struct list_node **link = &merged;
+  while(left != NULL && right != NULL){
+    // take from the left on ties to stay stable
+    if(right->data < left->data){
+      *link = right;
+      right = right->next;
+    }
+    else{
+      *link = left;
+      left = left->next;
+    }
+    link = &(*link)->next;
+  }
+  *link = left != NULL ? left : right;
+  return merged;
+}
+
+void list_partial_sort(struct list *self, size_t k) {
+  size_t size = list_size(self);
+  if(k > size){
+    k = size;
+  }
+  if(k == 0) return;
+  if(k < size){
+    select_nth(self, k - 1);
+  }
+  struct list_node *rest;
+  struct list_node *sorted = select_sort(self->first, k, &rest);
+  self->first = sorted;
+  while(sorted->next != NULL){
+    sorted = sorted->next;
+  }
+  sorted->next = rest;
+  list_relinked(self);
+}
+
+static void heap_swap(int *heap, size_t i, size_t j) {
+  int tmp = heap[i];
+  heap[i] = heap[j];
+  heap[j] = tmp;
+}
+
+/*
+ * Min heap: move down the value at i
+ */
+static void heap_sift_down(int *heap, size_t size, size_t i) {
+  for(;;){
+    size_t smallest = i;
+    size_t left = 2 * i + 1;
+    size_t right = left + 1;
+    if(left < size && heap[left] < heap[smallest]){
+      smallest = left;
+    }
+    if(right < size && heap[right] < heap[smallest]){
+      smallest = right;
+    }
+    if(smallest == i) return;
+    heap_swap(heap, i, smallest);
+    i = smallest;
+  }
+}
+
+static void heap_sift_up(int *heap, size_t i) {
+  while(i > 0 && heap[i] < heap[(i - 1) / 2]){
+    heap_swap(heap, i, (i - 1) / 2);
+    i = (i - 1) / 2;
+  }
+}
+
+size_t list_top_k(const struct list *self, int *out, size_t k) {
+  if(k == 0) return 0;
+  size_t size = 0;
+  for(struct list_node *curr = self->first; curr != NULL; curr = curr->next){
+    if(size < k){
+      out[size] = curr->data;
+      heap_sift_up(out, size);
+      ++size;
+    }
+    else if(curr->data > out[0]){
+      out[0] = curr->data;
+      heap_sift_down(out, size, 0);
+    }
+  }
+  // heap sort in place: popping the minimum to the end leaves the greatest first
+  for(size_t end = size; end > 1; --end){
+    heap_swap(out, 0, end - 1);
+    heap_sift_down(out, end - 1, 0);
+  }
+  return size;
+}
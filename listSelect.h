@@ -0,0 +1,44 @@
+#ifndef LIST_SELECT_H
+#define LIST_SELECT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Order statistics without sorting the whole list. The nodes are relinked,
+ * never copied, and nothing is allocated per element.
+ */
+
+/*
+ * Relink the list so that the element at index is the one that would be
+ * there if the list was sorted, with no greater element before it and no
+ * smaller one after it, and return it. Expected O(n) (quickselect).
+ * index is valid
+ */
+int list_nth_element(struct list *self, size_t index);
+
+/*
+ * Relink the list so that its k first elements are its k smallest in
+ * sorted order, the others are left in an unspecified order.
+ * O(n + k log k), k can be greater than the size of the list.
+ */
+void list_partial_sort(struct list *self, size_t k);
+
+/*
+ * Write the k greatest elements of the list in out, greatest first, and
+ * return how many were written (k or the size of the list if smaller).
+ * One pass with a heap of size k kept in out, O(n log k).
+ */
+size_t list_top_k(const struct list *self, int *out, size_t k);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIST_SELECT_H
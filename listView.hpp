@@ -0,0 +1,451 @@
+#ifndef LIST_VIEW_HPP
+#define LIST_VIEW_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "linkedList.h"
+
+/*
+ * Lazy views over struct list. Adaptors only wrap each other, nothing is
+ * read before a terminal (reduce, to_list, to_vector, to_array) pulls the
+ * values, so a whole pipeline is a single traversal without intermediate
+ * nodes:
+ *
+ *   auto view = list_views::all(l) | list_views::filter(pred) | list_views::transform(f) | list_views::take(10);
+ *   long long sum = list_views::reduce(view, 0LL, std::plus<>());
+ *
+ * Every view has a cursor whose next(value) gives the following value, or
+ * returns false at the end. The list must not change while a view is used.
+ */
+namespace list_views {
+
+/*
+ * Input iterator over a cursor, for range-based for loops
+ */
+template<typename Cursor, typename Value>
+class cursor_iterator {
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = Value;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Value *;
+  using reference = const Value &;
+
+  cursor_iterator() : cursor(), value(), done(true) {}
+
+  explicit cursor_iterator(Cursor cursor) : cursor(std::move(cursor)), value(), done(false) {
+    done = !this->cursor->next(value);
+  }
+
+  reference operator*() const { return value; }
+  pointer operator->() const { return &value; }
+
+  cursor_iterator &operator++() {
+    done = !cursor->next(value);
+    return *this;
+  }
+
+  bool operator==(const cursor_iterator &other) const { return done && other.done; }
+  bool operator!=(const cursor_iterator &other) const { return !(*this == other); }
+
+private:
+  std::optional<Cursor> cursor;
+  Value value;
+  bool done;
+};
+
+/*
+ * Common part of the views: iteration over the cursor
+ */
+template<typename Derived, typename Value>
+class view_base {
+public:
+  using value_type = Value;
+
+  auto begin() const {
+    return cursor_iterator<typename Derived::cursor, Value>(static_cast<const Derived *>(this)->make_cursor());
+  }
+
+  auto end() const {
+    return cursor_iterator<typename Derived::cursor, Value>();
+  }
+};
+
+/*
+ * Source view: the elements of a list
+ */
+class list_view : public view_base<list_view, int> {
+public:
+  class cursor {
+  public:
+    cursor() : curr(nullptr) {}
+    explicit cursor(const struct list_node *first) : curr(first) {}
+
+    bool next(int &value) {
+      if (curr == nullptr) {
+        return false;
+      }
+      value = curr->data;
+      curr = curr->next;
+      return true;
+    }
+
+  private:
+    const struct list_node *curr;
+  };
+
+  explicit list_view(const struct list &l) : l(&l) {}
+
+  cursor make_cursor() const { return cursor(l->first); }
+
+private:
+  const struct list *l;
+};
+
+inline list_view all(const struct list &l) {
+  return list_view(l);
+}
+
+template<typename View, typename Predicate>
+class filter_view : public view_base<filter_view<View, Predicate>, typename View::value_type> {
+public:
+  using value_type = typename View::value_type;
+
+  class cursor {
+  public:
+    cursor(typename View::cursor base, const Predicate *predicate) : base(std::move(base)), predicate(predicate) {}
+
+    bool next(value_type &value) {
+      while (base.next(value)) {
+        if ((*predicate)(value)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+  private:
+    typename View::cursor base;
+    const Predicate *predicate;
+  };
+
+  filter_view(View base, Predicate predicate) : base(std::move(base)), predicate(std::move(predicate)) {}
+
+  cursor make_cursor() const { return cursor(base.make_cursor(), &predicate); }
+
+private:
+  View base;
+  Predicate predicate;
+};
+
+template<typename View, typename Function>
+class transform_view : public view_base<transform_view<View, Function>, std::decay_t<std::invoke_result_t<const Function &, typename View::value_type>>> {
+public:
+  using value_type = std::decay_t<std::invoke_result_t<const Function &, typename View::value_type>>;
+
+  class cursor {
+  public:
+    cursor(typename View::cursor base, const Function *function) : base(std::move(base)), function(function) {}
+
+    bool next(value_type &value) {
+      typename View::value_type input;
+      if (!base.next(input)) {
+        return false;
+      }
+      value = (*function)(input);
+      return true;
+    }
+
+  private:
+    typename View::cursor base;
+    const Function *function;
+  };
+
+  transform_view(View base, Function function) : base(std::move(base)), function(std::move(function)) {}
+
+  cursor make_cursor() const { return cursor(base.make_cursor(), &function); }
+
+private:
+  View base;
+  Function function;
+};
+
+template<typename View>
+class take_view : public view_base<take_view<View>, typename View::value_type> {
+public:
+  using value_type = typename View::value_type;
+
+  class cursor {
+  public:
+    cursor(typename View::cursor base, std::size_t count) : base(std::move(base)), count(count) {}
+
+    bool next(value_type &value) {
+      // stops without reading further, so take ends the traversal early
+      if (count == 0) {
+        return false;
+      }
+      --count;
+      return base.next(value);
+    }
+
+  private:
+    typename View::cursor base;
+    std::size_t count;
+  };
+
+  take_view(View base, std::size_t count) : base(std::move(base)), count(count) {}
+
+  cursor make_cursor() const { return cursor(base.make_cursor(), count); }
+
+private:
+  View base;
+  std::size_t count;
+};
+
+template<typename View>
+class drop_view : public view_base<drop_view<View>, typename View::value_type> {
+public:
+  using value_type = typename View::value_type;
+
+  class cursor {
+  public:
+    cursor(typename View::cursor base, std::size_t count) : base(std::move(base)), count(count) {}
+
+    bool next(value_type &value) {
+      for (; count > 0; --count) {
+        if (!base.next(value)) {
+          count = 0;
+          return false;
+        }
+      }
+      return base.next(value);
+    }
+
+  private:
+    typename View::cursor base;
+    std::size_t count;
+  };
+
+  drop_view(View base, std::size_t count) : base(std::move(base)), count(count) {}
+
+  cursor make_cursor() const { return cursor(base.make_cursor(), count); }
+
+private:
+  View base;
+  std::size_t count;
+};
+
+/*
+ * Pairs of values of two views, stops at the end of the shorter one
+ */
+template<typename View1, typename View2>
+class zip_view : public view_base<zip_view<View1, View2>, std::pair<typename View1::value_type, typename View2::value_type>> {
+public:
+  using value_type = std::pair<typename View1::value_type, typename View2::value_type>;
+
+  class cursor {
+  public:
+    cursor(typename View1::cursor base1, typename View2::cursor base2) : base1(std::move(base1)), base2(std::move(base2)) {}
+
+    bool next(value_type &value) {
+      return base1.next(value.first) && base2.next(value.second);
+    }
+
+  private:
+    typename View1::cursor base1;
+    typename View2::cursor base2;
+  };
+
+  zip_view(View1 base1, View2 base2) : base1(std::move(base1)), base2(std::move(base2)) {}
+
+  cursor make_cursor() const { return cursor(base1.make_cursor(), base2.make_cursor()); }
+
+private:
+  View1 base1;
+  View2 base2;
+};
+
+/*
+ * Values of two sorted views in sorted order, the first view wins ties
+ */
+template<typename View1, typename View2>
+class merge_view : public view_base<merge_view<View1, View2>, typename View1::value_type> {
+public:
+  using value_type = typename View1::value_type;
+
+  class cursor {
+  public:
+    cursor(typename View1::cursor base1, typename View2::cursor base2)
+    : base1(std::move(base1)), base2(std::move(base2)), value1(), value2() {
+      has1 = this->base1.next(value1);
+      has2 = this->base2.next(value2);
+    }
+
+    bool next(value_type &value) {
+      if (has1 && (!has2 || !(value2 < value1))) {
+        value = value1;
+        has1 = base1.next(value1);
+        return true;
+      }
+      if (has2) {
+        value = value2;
+        has2 = base2.next(value2);
+        return true;
+      }
+      return false;
+    }
+
+  private:
+    typename View1::cursor base1;
+    typename View2::cursor base2;
+    value_type value1;
+    typename View2::value_type value2;
+    bool has1;
+    bool has2;
+  };
+
+  merge_view(View1 base1, View2 base2) : base1(std::move(base1)), base2(std::move(base2)) {}
+
+  cursor make_cursor() const { return cursor(base1.make_cursor(), base2.make_cursor()); }
+
+private:
+  View1 base1;
+  View2 base2;
+};
+
+/*
+ * Adaptors for the pipe syntax
+ */
+
+template<typename Predicate>
+struct filter_adaptor {
+  Predicate predicate;
+};
+
+template<typename Function>
+struct transform_adaptor {
+  Function function;
+};
+
+struct take_adaptor {
+  std::size_t count;
+};
+
+struct drop_adaptor {
+  std::size_t count;
+};
+
+template<typename Predicate>
+filter_adaptor<Predicate> filter(Predicate predicate) {
+  return { std::move(predicate) };
+}
+
+template<typename Function>
+transform_adaptor<Function> transform(Function function) {
+  return { std::move(function) };
+}
+
+inline take_adaptor take(std::size_t count) {
+  return { count };
+}
+
+inline drop_adaptor drop(std::size_t count) {
+  return { count };
+}
+
+template<typename View1, typename View2>
+zip_view<View1, View2> zip(View1 view1, View2 view2) {
+  return zip_view<View1, View2>(std::move(view1), std::move(view2));
+}
+
+template<typename View1, typename View2>
+merge_view<View1, View2> merge(View1 view1, View2 view2) {
+  return merge_view<View1, View2>(std::move(view1), std::move(view2));
+}
+
+template<typename View, typename Predicate>
+filter_view<View, Predicate> operator|(View view, filter_adaptor<Predicate> adaptor) {
+  return filter_view<View, Predicate>(std::move(view), std::move(adaptor.predicate));
+}
+
+template<typename View, typename Function>
+transform_view<View, Function> operator|(View view, transform_adaptor<Function> adaptor) {
+  return transform_view<View, Function>(std::move(view), std::move(adaptor.function));
+}
+
+template<typename View>
+take_view<View> operator|(View view, take_adaptor adaptor) {
+  return take_view<View>(std::move(view), adaptor.count);
+}
+
+template<typename View>
+drop_view<View> operator|(View view, drop_adaptor adaptor) {
+  return drop_view<View>(std::move(view), adaptor.count);
+}
+
+/*
+ * Terminals
+ */
+
+template<typename View, typename T, typename Op>
+T reduce(const View &view, T init, Op op) {
+  auto cursor = view.make_cursor();
+  typename View::value_type value;
+  while (cursor.next(value)) {
+    init = op(std::move(init), value);
+  }
+  return init;
+}
+
+/*
+ * Append the values at the end of a list, with its allocator
+ */
+template<typename View>
+void to_list(const View &view, struct list &out) {
+  struct list_node **link = &out.first;
+  while (*link != nullptr) {
+    link = &(*link)->next;
+  }
+  auto cursor = view.make_cursor();
+  typename View::value_type value;
+  while (cursor.next(value)) {
+    struct list_node *node = list_node_create(&out, value);
+    *link = node;
+    link = &node->next;
+    list_node_appended(&out, node);
+  }
+}
+
+template<typename View>
+std::vector<typename View::value_type> to_vector(const View &view) {
+  std::vector<typename View::value_type> out;
+  auto cursor = view.make_cursor();
+  typename View::value_type value;
+  while (cursor.next(value)) {
+    out.push_back(value);
+  }
+  return out;
+}
+
+/*
+ * Write at most size values in out, return the number of values written
+ */
+template<typename View, typename T>
+std::size_t to_array(const View &view, T *out, std::size_t size) {
+  auto cursor = view.make_cursor();
+  std::size_t count = 0;
+  typename View::value_type value;
+  while (count < size && cursor.next(value)) {
+    out[count++] = value;
+  }
+  return count;
+}
+
+} // namespace list_views
+
+#endif // LIST_VIEW_HPP
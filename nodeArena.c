@@ -0,0 +1,181 @@
+#include "nodeArena.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define LIST_ARENA_MMAP 1
+#endif
+
+#ifndef MPOL_BIND
+#define MPOL_BIND 2
+#endif
+
+/*
+ * Header at the beginning of each chunk, the nodes follow it
+ */
+struct list_node_arena_chunk {
+  struct list_node_arena_chunk *next;
+  size_t size;
+};
+
+#ifdef LIST_ARENA_MMAP
+
+/*
+ * Bind a range to a NUMA node with the raw system call, so libnuma is not needed
+ */
+static bool arena_bind(void *mem, size_t size, int numa_node) {
+#ifdef SYS_mbind
+  unsigned long mask[16] = { 0 };
+  size_t bits = 8 * sizeof(unsigned long);
+  if(numa_node < 0 || (size_t)numa_node >= bits * 16) return false;
+  mask[numa_node / bits] |= 1UL << (numa_node % bits);
+  return syscall(SYS_mbind, mem, size, MPOL_BIND, mask, bits * 16, 0) == 0;
+#else
+  (void)mem;
+  (void)size;
+  (void)numa_node;
+  return false;
+#endif
+}
+
+static void *arena_map(struct list_node_arena *self, size_t size, unsigned *obtained) {
+  void *mem = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if(self->requested & LIST_ARENA_HUGE_PAGES){
+    mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if(mem != MAP_FAILED){
+      *obtained |= LIST_ARENA_HUGE_PAGES;
+    }
+  }
+#endif
+  if(mem == MAP_FAILED){
+    // map one huge page more to align the chunk, transparent huge pages need it
+    size_t span = size + LIST_ARENA_HUGE_PAGE_SIZE;
+    char *raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(raw == MAP_FAILED) return NULL;
+    uintptr_t aligned = ((uintptr_t)raw + LIST_ARENA_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(LIST_ARENA_HUGE_PAGE_SIZE - 1);
+    char *start = (char *)aligned;
+    if(start > raw){
+      munmap(raw, start - raw);
+    }
+    if(raw + span > start + size){
+      munmap(start + size, raw + span - (start + size));
+    }
+    mem = start;
+#ifdef MADV_HUGEPAGE
+    if((self->requested & LIST_ARENA_TRANSPARENT_HUGE_PAGES) && madvise(mem, size, MADV_HUGEPAGE) == 0){
+      *obtained |= LIST_ARENA_TRANSPARENT_HUGE_PAGES;
+    }
+#endif
+  }
+  // before the first touch, so that the pages are faulted on the right node
+  if((self->requested & LIST_ARENA_NUMA_BIND) && arena_bind(mem, size, self->numa_node)){
+    *obtained |= LIST_ARENA_NUMA_BIND;
+  }
+  return mem;
+}
+
+static void arena_unmap(void *mem, size_t size) {
+  munmap(mem, size);
+}
+
+#else
+
+static void *arena_map(struct list_node_arena *self, size_t size, unsigned *obtained) {
+  (void)self;
+  (void)obtained;
+  return malloc(size);
+}
+
+static void arena_unmap(void *mem, size_t size) {
+  (void)size;
+  free(mem);
+}
+
+#endif
+
+static bool arena_grow(struct list_node_arena *self) {
+  unsigned obtained = 0;
+  struct list_node_arena_chunk *chunk = arena_map(self, self->chunk_size, &obtained);
+  if(chunk == NULL) return false;
+  chunk->next = self->chunks;
+  chunk->size = self->chunk_size;
+  self->chunks = chunk;
+  self->cursor = (char *)(chunk + 1);
+  self->end = (char *)chunk + self->chunk_size;
+  self->obtained &= obtained;
+  self->mapped += self->chunk_size;
+  return true;
+}
+
+static struct list_node *arena_allocate(void *ctx) {
+  struct list_node_arena *self = ctx;
+  struct list_node *node = self->free_nodes;
+  if(node != NULL){
+    self->free_nodes = node->next;
+    return node;
+  }
+  if((size_t)(self->end - self->cursor) < sizeof(struct list_node) && !arena_grow(self)){
+    return NULL;
+  }
+  node = (struct list_node *)self->cursor;
+  self->cursor += sizeof(struct list_node);
+  return node;
+}
+
+static void arena_deallocate(void *ctx, struct list_node *node) {
+  struct list_node_arena *self = ctx;
+  node->next = self->free_nodes;
+  self->free_nodes = node;
+}
+
+void list_node_arena_create(struct list_node_arena *self, size_t chunk_size, unsigned features, int numa_node) {
+  if(chunk_size == 0){
+    chunk_size = LIST_ARENA_DEFAULT_CHUNK_SIZE;
+  }
+  chunk_size = (chunk_size + LIST_ARENA_HUGE_PAGE_SIZE - 1) & ~(LIST_ARENA_HUGE_PAGE_SIZE - 1);
+
+  self->allocator.allocate = arena_allocate;
+  self->allocator.deallocate = arena_deallocate;
+  self->allocator.ctx = self;
+  self->free_nodes = NULL;
+  self->cursor = NULL;
+  self->end = NULL;
+  self->chunks = NULL;
+  self->chunk_size = chunk_size;
+  self->numa_node = numa_node;
+  self->requested = features;
+  self->obtained = features;
+  self->mapped = 0;
+
+  // map the first chunk now, so that the obtained features are known
+  arena_grow(self);
+}
+
+void list_node_arena_destroy(struct list_node_arena *self) {
+  struct list_node_arena_chunk *chunk = self->chunks;
+  while(chunk != NULL){
+    struct list_node_arena_chunk *next = chunk->next;
+    arena_unmap(chunk, chunk->size);
+    chunk = next;
+  }
+  self->chunks = NULL;
+  self->free_nodes = NULL;
+  self->cursor = NULL;
+  self->end = NULL;
+  self->mapped = 0;
+}
+
+unsigned list_node_arena_features(const struct list_node_arena *self) {
+  if(self->chunks == NULL) return 0;
+  return self->obtained;
+}
+
+size_t list_node_arena_mapped(const struct list_node_arena *self) {
+  return self->mapped;
+}
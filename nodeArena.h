@@ -0,0 +1,74 @@
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Features of an arena. They are requested at creation, the arena falls
+ * back silently when one is not available and list_node_arena_features
+ * tells which ones were actually obtained.
+ */
+enum list_node_arena_feature {
+  LIST_ARENA_HUGE_PAGES = 1,             // explicit huge pages (MAP_HUGETLB)
+  LIST_ARENA_TRANSPARENT_HUGE_PAGES = 2, // madvise(MADV_HUGEPAGE)
+  LIST_ARENA_NUMA_BIND = 4,              // memory bound to numa_node
+};
+
+#define LIST_ARENA_DEFAULT_CHUNK_SIZE ((size_t)32 << 20)
+#define LIST_ARENA_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+struct list_node_arena_chunk;
+
+/*
+ * Node allocator carving nodes out of big chunks of memory, so that a list
+ * is dense in memory and covered by few (huge) pages. Freed nodes are kept
+ * for reuse, the memory is only given back when the arena is destroyed.
+ * An arena is not thread safe, like the lists using it.
+ */
+struct list_node_arena {
+  struct list_allocator allocator; // give &arena.allocator to list_create_with_allocator
+  struct list_node *free_nodes;
+  char *cursor;
+  char *end;
+  struct list_node_arena_chunk *chunks;
+  size_t chunk_size;
+  int numa_node;
+  unsigned requested;
+  unsigned obtained;
+  size_t mapped;
+};
+
+/*
+ * Create an arena. chunk_size is rounded up to the huge page size (0 for the
+ * default), features is a combination of list_node_arena_feature and
+ * numa_node is only used with LIST_ARENA_NUMA_BIND.
+ */
+void list_node_arena_create(struct list_node_arena *self, size_t chunk_size, unsigned features, int numa_node);
+
+/*
+ * Destroy an arena and all its memory. The lists using it must not be used anymore.
+ */
+void list_node_arena_destroy(struct list_node_arena *self);
+
+/*
+ * Get the features obtained for every chunk mapped so far
+ */
+unsigned list_node_arena_features(const struct list_node_arena *self);
+
+/*
+ * Get the memory mapped by the arena in bytes
+ */
+size_t list_node_arena_mapped(const struct list_node_arena *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NODE_ARENA_H
@@ -0,0 +1,331 @@
+#include "nodeCache.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+struct cache_thread;
+
+/*
+ * Header at the beginning of each block, aligned on the block size so that
+ * the block of a node is found by masking its address
+ */
+struct cache_block {
+  struct cache_thread *owner; // never changes, even when the thread exits
+  struct cache_block *prev;
+  struct cache_block *next;
+  struct list_node *free_nodes;
+  size_t free_count;
+  size_t carved; // the nodes after carved were never handed out
+};
+
+#define CACHE_NODES_OFFSET ((sizeof(struct cache_block) + sizeof(struct list_node) - 1) / sizeof(struct list_node) * sizeof(struct list_node))
+#define CACHE_BLOCK_NODES ((LIST_NODE_CACHE_BLOCK_SIZE - CACHE_NODES_OFFSET) / sizeof(struct list_node))
+
+/*
+ * State of one thread for one cache. The blocks are only touched by their
+ * owner, or under the mutex of the cache once the owner has exited.
+ */
+struct cache_thread {
+  struct list_node_cache *cache;
+  struct cache_thread *next; // all the threads of the cache
+  struct cache_block *partial; // blocks with available nodes
+  struct cache_block *full;
+  size_t cached; // available nodes in the blocks
+  bool orphan;
+  _Atomic(struct list_node *) remote; // nodes freed by other threads
+
+  // nodes freed for another owner, pushed together
+  struct cache_thread *batch_owner;
+  struct list_node *batch_first;
+  struct list_node *batch_last;
+  size_t batch_count;
+};
+
+struct list_node_cache {
+  struct list_allocator allocator;
+  pthread_key_t key;
+  pthread_mutex_t mutex;
+  struct cache_thread *threads;
+  size_t capacity;
+  size_t batch;
+  atomic_size_t memory;
+};
+
+static struct cache_block *block_of(struct list_node *node) {
+  return (struct cache_block *)((uintptr_t)node & ~(uintptr_t)(LIST_NODE_CACHE_BLOCK_SIZE - 1));
+}
+
+static size_t block_available(const struct cache_block *block) {
+  return block->free_count + (CACHE_BLOCK_NODES - block->carved);
+}
+
+static void block_link(struct cache_block **head, struct cache_block *block) {
+  block->prev = NULL;
+  block->next = *head;
+  if(*head != NULL){
+    (*head)->prev = block;
+  }
+  *head = block;
+}
+
+static void block_unlink(struct cache_block **head, struct cache_block *block) {
+  if(block->prev != NULL){
+    block->prev->next = block->next;
+  }
+  else{
+    *head = block->next;
+  }
+  if(block->next != NULL){
+    block->next->prev = block->prev;
+  }
+}
+
+static struct cache_block *block_create(struct cache_thread *thread) {
+  struct cache_block *block = aligned_alloc(LIST_NODE_CACHE_BLOCK_SIZE, LIST_NODE_CACHE_BLOCK_SIZE);
+  if(block == NULL) return NULL;
+  block->owner = thread;
+  block->free_nodes = NULL;
+  block->free_count = 0;
+  block->carved = 0;
+  block_link(&thread->partial, block);
+  thread->cached += CACHE_BLOCK_NODES;
+  atomic_fetch_add_explicit(&thread->cache->memory, LIST_NODE_CACHE_BLOCK_SIZE, memory_order_relaxed);
+  return block;
+}
+
+/*
+ * Give back a block whose nodes are all free
+ */
+static void block_release(struct cache_thread *thread, struct cache_block *block) {
+  block_unlink(&thread->partial, block);
+  thread->cached -= CACHE_BLOCK_NODES;
+  atomic_fetch_sub_explicit(&thread->cache->memory, LIST_NODE_CACHE_BLOCK_SIZE, memory_order_relaxed);
+  free(block);
+}
+
+static void block_release_free(struct cache_thread *thread) {
+  struct cache_block *block = thread->partial;
+  while(block != NULL){
+    struct cache_block *next = block->next;
+    if(block->free_count == block->carved){
+      block_release(thread, block);
+    }
+    block = next;
+  }
+}
+
+/*
+ * Free a node of a block owned by thread
+ */
+static void local_free(struct cache_thread *thread, struct list_node *node) {
+  struct cache_block *block = block_of(node);
+  assert(block->owner == thread);
+  if(block_available(block) == 0){
+    block_unlink(&thread->full, block);
+    block_link(&thread->partial, block);
+  }
+  node->next = block->free_nodes;
+  block->free_nodes = node;
+  ++block->free_count;
+  ++thread->cached;
+  if(block->free_count == block->carved && (thread->orphan || thread->cached > thread->cache->capacity)){
+    block_release(thread, block);
+  }
+}
+
+static void take_remote(struct cache_thread *thread) {
+  struct list_node *node = atomic_exchange_explicit(&thread->remote, NULL, memory_order_acquire);
+  while(node != NULL){
+    struct list_node *next = node->next;
+    local_free(thread, node);
+    node = next;
+  }
+}
+
+static struct list_node *local_allocate(struct cache_thread *thread) {
+  if(thread->partial == NULL){
+    take_remote(thread);
+  }
+  if(thread->partial == NULL && block_create(thread) == NULL) return NULL;
+  struct cache_block *block = thread->partial;
+  struct list_node *node;
+  if(block->free_nodes != NULL){
+    node = block->free_nodes;
+    block->free_nodes = node->next;
+    --block->free_count;
+  }
+  else{
+    node = (struct list_node *)((char *)block + CACHE_NODES_OFFSET) + block->carved;
+    ++block->carved;
+  }
+  --thread->cached;
+  if(block_available(block) == 0){
+    block_unlink(&thread->partial, block);
+    block_link(&thread->full, block);
+  }
+  return node;
+}
+
+/*
+ * Push a chain of nodes to their owner with one compare and swap
+ */
+static void remote_push(struct cache_thread *owner, struct list_node *first, struct list_node *last) {
+  struct list_node *head = atomic_load_explicit(&owner->remote, memory_order_relaxed);
+  do{
+    last->next = head;
+  }while(!atomic_compare_exchange_weak_explicit(&owner->remote, &head, first, memory_order_release, memory_order_relaxed));
+}
+
+static void batch_flush(struct cache_thread *thread) {
+  if(thread->batch_count == 0) return;
+  remote_push(thread->batch_owner, thread->batch_first, thread->batch_last);
+  thread->batch_first = NULL;
+  thread->batch_last = NULL;
+  thread->batch_count = 0;
+}
+
+static void remote_free(struct cache_thread *thread, struct cache_thread *owner, struct list_node *node) {
+  if(thread->batch_owner != owner){
+    batch_flush(thread);
+    thread->batch_owner = owner;
+  }
+  node->next = thread->batch_first;
+  if(thread->batch_first == NULL){
+    thread->batch_last = node;
+  }
+  thread->batch_first = node;
+  if(++thread->batch_count >= thread->cache->batch){
+    batch_flush(thread);
+  }
+}
+
+/*
+ * Release the memory of the exited threads whose nodes are all free again,
+ * under the mutex
+ */
+static void reap_orphans(struct list_node_cache *self) {
+  struct cache_thread **link = &self->threads;
+  while(*link != NULL){
+    struct cache_thread *thread = *link;
+    if(thread->orphan){
+      take_remote(thread);
+      block_release_free(thread);
+      if(thread->partial == NULL && thread->full == NULL){
+        *link = thread->next;
+        free(thread);
+        continue;
+      }
+    }
+    link = &thread->next;
+  }
+}
+
+static void thread_exit(void *ctx) {
+  struct cache_thread *thread = ctx;
+  struct list_node_cache *self = thread->cache;
+  batch_flush(thread);
+  pthread_mutex_lock(&self->mutex);
+  thread->orphan = true;
+  reap_orphans(self);
+  pthread_mutex_unlock(&self->mutex);
+}
+
+static struct cache_thread *thread_get(struct list_node_cache *self) {
+  struct cache_thread *thread = pthread_getspecific(self->key);
+  if(thread != NULL) return thread;
+  thread = calloc(1, sizeof(struct cache_thread));
+  if(thread == NULL) return NULL;
+  thread->cache = self;
+  atomic_init(&thread->remote, NULL);
+  if(pthread_setspecific(self->key, thread) != 0){
+    free(thread);
+    return NULL;
+  }
+  pthread_mutex_lock(&self->mutex);
+  reap_orphans(self);
+  thread->next = self->threads;
+  self->threads = thread;
+  pthread_mutex_unlock(&self->mutex);
+  return thread;
+}
+
+static struct list_node *cache_allocate(void *ctx) {
+  struct cache_thread *thread = thread_get(ctx);
+  if(thread == NULL) return NULL;
+  return local_allocate(thread);
+}
+
+static void cache_deallocate(void *ctx, struct list_node *node) {
+  struct cache_thread *owner = block_of(node)->owner;
+  struct cache_thread *thread = thread_get(ctx);
+  if(thread == owner){
+    local_free(thread, node);
+  }
+  else if(thread != NULL){
+    remote_free(thread, owner, node);
+  }
+  else{
+    remote_push(owner, node, node);
+  }
+}
+
+struct list_node_cache *list_node_cache_create(size_t capacity, size_t batch) {
+  struct list_node_cache *self = malloc(sizeof(struct list_node_cache));
+  if(self == NULL) return NULL;
+  if(pthread_key_create(&self->key, thread_exit) != 0){
+    free(self);
+    return NULL;
+  }
+  pthread_mutex_init(&self->mutex, NULL);
+  self->allocator.allocate = cache_allocate;
+  self->allocator.deallocate = cache_deallocate;
+  self->allocator.ctx = self;
+  self->threads = NULL;
+  self->capacity = capacity == 0 ? LIST_NODE_CACHE_DEFAULT_CAPACITY : capacity;
+  self->batch = batch == 0 ? LIST_NODE_CACHE_DEFAULT_BATCH : batch;
+  atomic_init(&self->memory, 0);
+  return self;
+}
+
+static void block_free_all(struct cache_block *block) {
+  while(block != NULL){
+    struct cache_block *next = block->next;
+    free(block);
+    block = next;
+  }
+}
+
+void list_node_cache_destroy(struct list_node_cache *self) {
+  pthread_key_delete(self->key);
+  struct cache_thread *thread = self->threads;
+  while(thread != NULL){
+    struct cache_thread *next = thread->next;
+    block_free_all(thread->partial);
+    block_free_all(thread->full);
+    free(thread);
+    thread = next;
+  }
+  pthread_mutex_destroy(&self->mutex);
+  free(self);
+}
+
+const struct list_allocator *list_node_cache_allocator(const struct list_node_cache *self) {
+  return &self->allocator;
+}
+
+void list_node_cache_flush(struct list_node_cache *self) {
+  struct cache_thread *thread = pthread_getspecific(self->key);
+  if(thread != NULL){
+    batch_flush(thread);
+  }
+  pthread_mutex_lock(&self->mutex);
+  reap_orphans(self);
+  pthread_mutex_unlock(&self->mutex);
+}
+
+size_t list_node_cache_memory(const struct list_node_cache *self) {
+  return atomic_load_explicit(&self->memory, memory_order_relaxed);
+}
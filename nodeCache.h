@@ -0,0 +1,65 @@
+#ifndef NODE_CACHE_H
+#define NODE_CACHE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIST_NODE_CACHE_BLOCK_SIZE ((size_t)16 << 10)
+#define LIST_NODE_CACHE_DEFAULT_CAPACITY 4096
+#define LIST_NODE_CACHE_DEFAULT_BATCH 64
+
+/*
+ * Thread safe node allocator with a cache per thread. Each thread carves
+ * its nodes out of its own blocks, whose header tells the owner of a node.
+ * A node freed by its owner goes back to its block without any
+ * synchronization, a node freed by another thread is batched with the
+ * other nodes of the same owner and the batch is pushed to the owner with
+ * a single atomic operation. The owner takes them back when it runs out
+ * of free nodes.
+ *
+ * A block whose nodes are all free is given back to malloc when its thread
+ * caches more than capacity free nodes. When a thread exits, its blocks
+ * still in use are orphaned, they are released once their nodes are all
+ * freed, by list_node_cache_flush or when a thread starts or stops using
+ * the cache.
+ */
+struct list_node_cache;
+
+/*
+ * Create a cache (0 for the defaults), return NULL if it failed
+ */
+struct list_node_cache *list_node_cache_create(size_t capacity, size_t batch);
+
+/*
+ * Destroy a cache and all its memory. The lists using it must not be used
+ * anymore and no thread must use the cache afterwards.
+ */
+void list_node_cache_destroy(struct list_node_cache *self);
+
+/*
+ * Get the allocator to give to list_create_with_allocator
+ */
+const struct list_allocator *list_node_cache_allocator(const struct list_node_cache *self);
+
+/*
+ * Push the nodes of the calling thread freed for other threads to their
+ * owners without waiting for a full batch
+ */
+void list_node_cache_flush(struct list_node_cache *self);
+
+/*
+ * Get the memory of the blocks currently allocated by the cache in bytes
+ */
+size_t list_node_cache_memory(const struct list_node_cache *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NODE_CACHE_H
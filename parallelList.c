@@ -0,0 +1,409 @@
+#include "parallelList.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "listChain.h"
+
+#define LIST_CHUNKS_PER_THREAD 4
+
+typedef void (*list_chunk_task)(size_t chunk, void *ctx);
+
+struct list_thread_pool {
+  pthread_t *threads;
+  size_t size;
+  pthread_mutex_t mutex;
+  pthread_cond_t wake;
+  pthread_cond_t done;
+  unsigned long generation;
+  bool stop;
+  list_chunk_task task;
+  void *ctx;
+  size_t chunks;
+  atomic_size_t next_chunk;
+  size_t active;
+};
+
+/*
+ * Chunks of a list: chunk i goes from starts[i] to starts[i+1] (excluded)
+ */
+struct list_chunks {
+  struct list_node **starts;
+  size_t count;
+};
+
+static void pool_run_chunks(struct list_thread_pool *pool) {
+  for(;;){
+    size_t chunk = atomic_fetch_add_explicit(&pool->next_chunk, 1, memory_order_relaxed);
+    if(chunk >= pool->chunks) return;
+    pool->task(chunk, pool->ctx);
+  }
+}
+
+static void *pool_worker(void *arg) {
+  struct list_thread_pool *pool = arg;
+  unsigned long seen = 0;
+  pthread_mutex_lock(&pool->mutex);
+  for(;;){
+    while(!pool->stop && pool->generation == seen){
+      pthread_cond_wait(&pool->wake, &pool->mutex);
+    }
+    if(pool->stop) break;
+    seen = pool->generation;
+    pthread_mutex_unlock(&pool->mutex);
+    pool_run_chunks(pool);
+    pthread_mutex_lock(&pool->mutex);
+    if(--pool->active == 0){
+      pthread_cond_signal(&pool->done);
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return NULL;
+}
+
+/*
+ * Run task on every chunk, the calling thread works too
+ */
+static void pool_run(struct list_thread_pool *pool, size_t chunks, list_chunk_task task, void *ctx) {
+  pthread_mutex_lock(&pool->mutex);
+  pool->task = task;
+  pool->ctx = ctx;
+  pool->chunks = chunks;
+  atomic_store_explicit(&pool->next_chunk, 0, memory_order_relaxed);
+  pool->active = pool->size;
+  ++pool->generation;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->mutex);
+
+  pool_run_chunks(pool);
+
+  pthread_mutex_lock(&pool->mutex);
+  while(pool->active > 0){
+    pthread_cond_wait(&pool->done, &pool->mutex);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+struct list_thread_pool *list_thread_pool_create(size_t threads) {
+  if(threads == 0){
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = online > 0 ? (size_t)online : 1;
+  }
+  struct list_thread_pool *pool = malloc(sizeof(struct list_thread_pool));
+  if(pool == NULL) return NULL;
+  // the calling thread is one of the workers
+  pool->threads = malloc(threads * sizeof(pthread_t));
+  if(pool->threads == NULL){
+    free(pool);
+    return NULL;
+  }
+  pool->size = 0;
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->wake, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  pool->generation = 0;
+  pool->stop = false;
+  pool->task = NULL;
+  pool->ctx = NULL;
+  pool->chunks = 0;
+  atomic_init(&pool->next_chunk, 0);
+  pool->active = 0;
+  for(size_t i=0; i+1<threads; ++i){
+    if(pthread_create(&pool->threads[i], NULL, pool_worker, pool) != 0){
+      list_thread_pool_destroy(pool);
+      return NULL;
+    }
+    ++pool->size;
+  }
+  return pool;
+}
+
+void list_thread_pool_destroy(struct list_thread_pool *pool) {
+  pthread_mutex_lock(&pool->mutex);
+  pool->stop = true;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->mutex);
+  for(size_t i=0; i<pool->size; ++i){
+    pthread_join(pool->threads[i], NULL);
+  }
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->threads);
+  free(pool);
+}
+
+size_t list_thread_pool_size(const struct list_thread_pool *pool) {
+  return pool->size + 1;
+}
+
+/*
+ * Cut the list in chunks in a single pass without knowing its size: a start
+ * is recorded every step nodes, and when the array is full every other start
+ * is dropped and the step doubles. In the end there are between target and
+ * 2 * target chunks of nearly the same size (or one chunk per node).
+ */
+static bool list_chunks_create(struct list_chunks *self, const struct list *list, size_t target) {
+  size_t capacity = 2 * target;
+  self->starts = malloc((capacity + 1) * sizeof(struct list_node *));
+  if(self->starts == NULL) return false;
+  self->count = 0;
+  size_t step = 1;
+  size_t i = 0;
+  for(struct list_node *curr = list->first; curr != NULL; curr = curr->next){
+    if(i % step == 0){
+      if(self->count == capacity){
+        for(size_t j=0; j<capacity/2; ++j){
+          self->starts[j] = self->starts[2*j];
+        }
+        self->count = capacity / 2;
+        step *= 2;
+      }
+      self->starts[self->count++] = curr;
+    }
+    ++i;
+  }
+  self->starts[self->count] = NULL;
+  return true;
+}
+
+static void list_chunks_destroy(struct list_chunks *self) {
+  free(self->starts);
+}
+
+static size_t pool_target_chunks(const struct list_thread_pool *pool) {
+  return list_thread_pool_size(pool) * LIST_CHUNKS_PER_THREAD;
+}
+
+/*
+ * reduce
+ */
+
+struct reduce_job {
+  struct list_chunks chunks;
+  list_reduce_op op;
+  long long init;
+  void *ctx;
+  long long *results;
+};
+
+static void reduce_task(size_t chunk, void *ctx) {
+  struct reduce_job *job = ctx;
+  long long acc = job->init;
+  struct list_node *end = job->chunks.starts[chunk + 1];
+  for(struct list_node *curr = job->chunks.starts[chunk]; curr != end; curr = curr->next){
+    acc = job->op(acc, curr->data, job->ctx);
+  }
+  job->results[chunk] = acc;
+}
+
+long long list_parallel_reduce(const struct list *self, struct list_thread_pool *pool, list_reduce_op op, long long init, void *ctx) {
+  struct reduce_job job = { .op = op, .init = init, .ctx = ctx };
+  if(!list_chunks_create(&job.chunks, self, pool_target_chunks(pool))) return init;
+  job.results = malloc((job.chunks.count + 1) * sizeof(long long));
+  if(job.results == NULL){
+    list_chunks_destroy(&job.chunks);
+    return init;
+  }
+  pool_run(pool, job.chunks.count, reduce_task, &job);
+  long long acc = init;
+  for(size_t i=0; i<job.chunks.count; ++i){
+    acc = op(acc, job.results[i], ctx);
+  }
+  free(job.results);
+  list_chunks_destroy(&job.chunks);
+  return acc;
+}
+
+static long long sum_op(long long acc, long long value, void *ctx) {
+  (void)ctx;
+  return acc + value;
+}
+
+long long list_parallel_sum(const struct list *self, struct list_thread_pool *pool) {
+  return list_parallel_reduce(self, pool, sum_op, 0, NULL);
+}
+
+/*
+ * min / max
+ */
+
+struct min_max_job {
+  struct list_chunks chunks;
+  int *mins;
+  int *maxs;
+};
+
+static void min_max_task(size_t chunk, void *ctx) {
+  struct min_max_job *job = ctx;
+  int min = INT_MAX;
+  int max = INT_MIN;
+  struct list_node *end = job->chunks.starts[chunk + 1];
+  for(struct list_node *curr = job->chunks.starts[chunk]; curr != end; curr = curr->next){
+    if(curr->data < min) min = curr->data;
+    if(curr->data > max) max = curr->data;
+  }
+  job->mins[chunk] = min;
+  job->maxs[chunk] = max;
+}
+
+bool list_parallel_min_max(const struct list *self, struct list_thread_pool *pool, int *min, int *max) {
+  if(self->first == NULL) return false;
+  struct min_max_job job;
+  if(!list_chunks_create(&job.chunks, self, pool_target_chunks(pool))) return false;
+  job.mins = malloc(job.chunks.count * sizeof(int));
+  job.maxs = malloc(job.chunks.count * sizeof(int));
+  if(job.mins == NULL || job.maxs == NULL){
+    free(job.maxs);
+    free(job.mins);
+    list_chunks_destroy(&job.chunks);
+    return false;
+  }
+  pool_run(pool, job.chunks.count, min_max_task, &job);
+  *min = INT_MAX;
+  *max = INT_MIN;
+  for(size_t i=0; i<job.chunks.count; ++i){
+    if(job.mins[i] < *min) *min = job.mins[i];
+    if(job.maxs[i] > *max) *max = job.maxs[i];
+  }
+  free(job.maxs);
+  free(job.mins);
+  list_chunks_destroy(&job.chunks);
+  return true;
+}
+
+/*
+ * count_if
+ */
+
+struct count_job {
+  struct list_chunks chunks;
+  list_value_predicate predicate;
+  void *ctx;
+  size_t *counts;
+};
+
+static void count_task(size_t chunk, void *ctx) {
+  struct count_job *job = ctx;
+  size_t count = 0;
+  struct list_node *end = job->chunks.starts[chunk + 1];
+  for(struct list_node *curr = job->chunks.starts[chunk]; curr != end; curr = curr->next){
+    if(job->predicate(curr->data, job->ctx)) ++count;
+  }
+  job->counts[chunk] = count;
+}
+
+size_t list_parallel_count_if(const struct list *self, struct list_thread_pool *pool, list_value_predicate predicate, void *ctx) {
+  struct count_job job = { .predicate = predicate, .ctx = ctx };
+  if(!list_chunks_create(&job.chunks, self, pool_target_chunks(pool))) return 0;
+  job.counts = malloc((job.chunks.count + 1) * sizeof(size_t));
+  if(job.counts == NULL){
+    list_chunks_destroy(&job.chunks);
+    return 0;
+  }
+  pool_run(pool, job.chunks.count, count_task, &job);
+  size_t count = 0;
+  for(size_t i=0; i<job.chunks.count; ++i){
+    count += job.counts[i];
+  }
+  free(job.counts);
+  list_chunks_destroy(&job.chunks);
+  return count;
+}
+
+/*
+ * transform
+ */
+
+struct transform_job {
+  struct list_chunks chunks;
+  list_transform_op op;
+  void *ctx;
+};
+
+static void transform_task(size_t chunk, void *ctx) {
+  struct transform_job *job = ctx;
+  struct list_node *end = job->chunks.starts[chunk + 1];
+  for(struct list_node *curr = job->chunks.starts[chunk]; curr != end; curr = curr->next){
+    curr->data = job->op(curr->data, job->ctx);
+  }
+}
+
+void list_parallel_transform(struct list *self, struct list_thread_pool *pool, list_transform_op op, void *ctx) {
+  struct transform_job job = { .op = op, .ctx = ctx };
+  if(!list_chunks_create(&job.chunks, self, pool_target_chunks(pool))) return;
+  pool_run(pool, job.chunks.count, transform_task, &job);
+  list_chunks_destroy(&job.chunks);
+  list_relinked(self);
+}
+
+/*
+ * filter
+ */
+
+struct filter_job {
+  struct list_chunks chunks;
+  list_value_predicate predicate;
+  void *ctx;
+  struct list_chain *kept;
+  struct list_chain *moved;
+};
+
+static void filter_task(size_t chunk, void *ctx) {
+  struct filter_job *job = ctx;
+  struct list_chain kept = LIST_CHAIN_EMPTY;
+  struct list_chain moved = LIST_CHAIN_EMPTY;
+  struct list_node *end = job->chunks.starts[chunk + 1];
+  struct list_node *curr = job->chunks.starts[chunk];
+  while(curr != end){
+    // only the nodes of this chunk are relinked, next is read first
+    struct list_node *next = curr->next;
+    if(job->predicate(curr->data, job->ctx)){
+      list_chain_append(&moved, curr);
+    }
+    else{
+      list_chain_append(&kept, curr);
+    }
+    curr = next;
+  }
+  job->kept[chunk] = kept;
+  job->moved[chunk] = moved;
+}
+
+static struct list_node **chain_stitch(struct list_node **link, const struct list_chain *chains, size_t count) {
+  for(size_t i=0; i<count; ++i){
+    link = list_chain_link(link, &chains[i]);
+  }
+  *link = NULL;
+  return link;
+}
+
+void list_parallel_filter(struct list *self, struct list *out, struct list_thread_pool *pool, list_value_predicate predicate, void *ctx) {
+  struct filter_job job = { .predicate = predicate, .ctx = ctx };
+  if(!list_chunks_create(&job.chunks, self, pool_target_chunks(pool))) return;
+  job.kept = malloc((job.chunks.count + 1) * sizeof(struct list_chain));
+  job.moved = malloc((job.chunks.count + 1) * sizeof(struct list_chain));
+  if(job.kept == NULL || job.moved == NULL){
+    free(job.moved);
+    free(job.kept);
+    list_chunks_destroy(&job.chunks);
+    return;
+  }
+  pool_run(pool, job.chunks.count, filter_task, &job);
+
+  struct list_node **out_link = &out->first;
+  while(*out_link != NULL){
+    out_link = &(*out_link)->next;
+  }
+  chain_stitch(out_link, job.moved, job.chunks.count);
+  chain_stitch(&self->first, job.kept, job.chunks.count);
+  list_relinked(out);
+  list_relinked(self);
+
+  free(job.moved);
+  free(job.kept);
+  list_chunks_destroy(&job.chunks);
+}
@@ -0,0 +1,74 @@
+#ifndef PARALLEL_LIST_H
+#define PARALLEL_LIST_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Fixed pool of worker threads running the parallel algorithms. The list
+ * is cut in chunks in one linear pass, then each worker processes chunks.
+ */
+struct list_thread_pool;
+
+typedef long long (*list_reduce_op)(long long acc, long long value, void *ctx);
+typedef int (*list_transform_op)(int value, void *ctx);
+
+/*
+ * Create a pool of threads workers (0 for the number of processors), return NULL if it failed
+ */
+struct list_thread_pool *list_thread_pool_create(size_t threads);
+
+/*
+ * Stop and destroy a pool
+ */
+void list_thread_pool_destroy(struct list_thread_pool *pool);
+
+/*
+ * Get the number of workers of a pool
+ */
+size_t list_thread_pool_size(const struct list_thread_pool *pool);
+
+/*
+ * Reduce the list: each chunk is folded from init, then the results of the
+ * chunks are folded in order. op must be associative and init its identity.
+ */
+long long list_parallel_reduce(const struct list *self, struct list_thread_pool *pool, list_reduce_op op, long long init, void *ctx);
+
+/*
+ * Sum of the elements
+ */
+long long list_parallel_sum(const struct list *self, struct list_thread_pool *pool);
+
+/*
+ * Minimum and maximum of the elements, return false if the list is empty
+ */
+bool list_parallel_min_max(const struct list *self, struct list_thread_pool *pool, int *min, int *max);
+
+/*
+ * Count the elements matching the predicate
+ */
+size_t list_parallel_count_if(const struct list *self, struct list_thread_pool *pool, list_value_predicate predicate, void *ctx);
+
+/*
+ * Replace each element by op(element)
+ */
+void list_parallel_transform(struct list *self, struct list_thread_pool *pool, list_transform_op op, void *ctx);
+
+/*
+ * Move the elements matching the predicate at the end of out, preserving
+ * their order, by relinking the nodes. The others stay in self, in order.
+ * out uses the same allocator as self.
+ */
+void list_parallel_filter(struct list *self, struct list *out, struct list_thread_pool *pool, list_value_predicate predicate, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARALLEL_LIST_H
@@ -0,0 +1,198 @@
+#include "persistentList.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+struct plist_node {
+  int data;
+  atomic_size_t refs;
+  struct plist_node *next;
+};
+
+static struct plist_node *plist_node_create(int value, struct plist_node *next) {
+  struct plist_node *new = malloc(sizeof(struct plist_node));
+  new->data = value;
+  atomic_init(&new->refs, 1);
+  new->next = next;
+  return new;
+}
+
+static struct plist_node *plist_node_acquire(struct plist_node *node) {
+  if(node != NULL){
+    atomic_fetch_add_explicit(&node->refs, 1, memory_order_relaxed);
+  }
+  return node;
+}
+
+static void plist_node_release(struct plist_node *node) {
+  // iterative, a long unshared chain must not blow the stack
+  while(node != NULL){
+    if(atomic_fetch_sub_explicit(&node->refs, 1, memory_order_release) != 1){
+      return;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    struct plist_node *next = node->next;
+    free(node);
+    node = next;
+  }
+}
+
+static void plist_publish(struct plist *self, const struct plist *other, struct plist_node *first, size_t size) {
+  if(self == other){
+    plist_node_release(self->first);
+  }
+  self->first = first;
+  self->size = size;
+}
+
+/*
+ * Copy the first index nodes of other in front of tail.
+ * tail is already acquired.
+ */
+static struct plist_node *plist_copy_prefix(const struct plist *other, size_t index, struct plist_node *tail) {
+  struct plist_node *first = tail;
+  struct plist_node **link = &first;
+  struct plist_node *curr = other->first;
+  for(size_t i=0; i<index; ++i){
+    struct plist_node *new = plist_node_create(curr->data, tail);
+    *link = new;
+    link = &new->next;
+    curr = curr->next;
+  }
+  return first;
+}
+
+static struct plist_node *plist_node_at(const struct plist *self, size_t index) {
+  struct plist_node *curr = self->first;
+  for(size_t i=0; i<index; ++i){
+    curr = curr->next;
+  }
+  return curr;
+}
+
+void plist_create(struct plist *self) {
+  self->first = NULL;
+  self->size = 0;
+}
+
+void plist_create_from(struct plist *self, const int *other, size_t size) {
+  struct plist_node *first = NULL;
+  for(size_t i=size; i>0; --i){
+    first = plist_node_create(other[i-1], first);
+  }
+  self->first = first;
+  self->size = size;
+}
+
+void plist_create_from_list(struct plist *self, const struct list *other) {
+  struct plist_node *first = NULL;
+  struct plist_node **link = &first;
+  size_t size = 0;
+  for(struct list_node *curr = other->first; curr != NULL; curr = curr->next){
+    struct plist_node *new = plist_node_create(curr->data, NULL);
+    *link = new;
+    link = &new->next;
+    ++size;
+  }
+  self->first = first;
+  self->size = size;
+}
+
+void plist_copy(struct plist *self, const struct plist *other) {
+  if(self == other){
+    return;
+  }
+  self->first = plist_node_acquire(other->first);
+  self->size = other->size;
+}
+
+void plist_destroy(struct plist *self) {
+  plist_node_release(self->first);
+  self->first = NULL;
+  self->size = 0;
+}
+
+bool plist_empty(const struct plist *self) {
+  return self->first == NULL;
+}
+
+size_t plist_size(const struct plist *self) {
+  return self->size;
+}
+
+bool plist_equals(const struct plist *self, const int *data, size_t size) {
+  if(self->size != size) return false;
+  struct plist_node *curr = self->first;
+  for(size_t i=0; i<size; ++i){
+    if(curr->data != data[i]) return false;
+    curr = curr->next;
+  }
+  return true;
+}
+
+int plist_front(const struct plist *self) {
+  if(self->first == NULL) return 0;
+  return self->first->data;
+}
+
+void plist_push_front(struct plist *self, const struct plist *other, int value) {
+  struct plist_node *first = plist_node_create(value, plist_node_acquire(other->first));
+  plist_publish(self, other, first, other->size + 1);
+}
+
+void plist_pop_front(struct plist *self, const struct plist *other) {
+  assert(other->first != NULL);
+  struct plist_node *first = plist_node_acquire(other->first->next);
+  plist_publish(self, other, first, other->size - 1);
+}
+
+void plist_insert(struct plist *self, const struct plist *other, int value, size_t index) {
+  assert(index <= other->size);
+  struct plist_node *tail = plist_node_acquire(plist_node_at(other, index));
+  struct plist_node *new = plist_node_create(value, tail);
+  struct plist_node *first = plist_copy_prefix(other, index, new);
+  plist_publish(self, other, first, other->size + 1);
+}
+
+void plist_remove(struct plist *self, const struct plist *other, size_t index) {
+  assert(index < other->size);
+  struct plist_node *tail = plist_node_acquire(plist_node_at(other, index)->next);
+  struct plist_node *first = plist_copy_prefix(other, index, tail);
+  plist_publish(self, other, first, other->size - 1);
+}
+
+void plist_set(struct plist *self, const struct plist *other, size_t index, int value) {
+  assert(index < other->size);
+  struct plist_node *tail = plist_node_acquire(plist_node_at(other, index)->next);
+  struct plist_node *new = plist_node_create(value, tail);
+  struct plist_node *first = plist_copy_prefix(other, index, new);
+  plist_publish(self, other, first, other->size);
+}
+
+int plist_get(const struct plist *self, size_t index) {
+  if(index >= self->size) return 0;
+  return plist_node_at(self, index)->data;
+}
+
+size_t plist_search(const struct plist *self, int value) {
+  size_t i = 0;
+  for(struct plist_node *curr = self->first; curr != NULL; curr = curr->next){
+    if(curr->data == value) return i;
+    ++i;
+  }
+  return self->size;
+}
+
+void plist_to_list(const struct plist *self, struct list *out) {
+  struct list_node **link = &out->first;
+  while(*link != NULL){
+    link = &(*link)->next;
+  }
+  for(struct plist_node *curr = self->first; curr != NULL; curr = curr->next){
+    struct list_node *new = list_node_create(out, curr->data);
+    *link = new;
+    link = &new->next;
+    list_node_appended(out, new);
+  }
+}
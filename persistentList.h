@@ -0,0 +1,131 @@
+#ifndef PERSISTENT_LIST_H
+#define PERSISTENT_LIST_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Nodes are immutable once published and reference counted, so a version
+ * can be shared between any number of other versions and threads.
+ */
+struct plist_node;
+
+/*
+ * A version of a persistent list. Each version owns one reference to its
+ * first node. A version must be used by one thread at a time, other threads
+ * get their own version with plist_copy.
+ */
+struct plist {
+  struct plist_node *first;
+  size_t size;
+};
+
+/*
+ * In every function producing a version, self receives the new version.
+ * If self is the same as other, the previous version is released,
+ * otherwise self is considered uninitialized.
+ */
+
+/*
+ * Create an empty persistent list
+ */
+void plist_create(struct plist *self);
+
+/*
+ * Create a persistent list with initial content
+ */
+void plist_create_from(struct plist *self, const int *other, size_t size);
+
+/*
+ * Create a persistent list with the content of a list
+ */
+void plist_create_from_list(struct plist *self, const struct list *other);
+
+/*
+ * Make self another version sharing every node of other (snapshot in O(1))
+ */
+void plist_copy(struct plist *self, const struct plist *other);
+
+/*
+ * Release a version, nodes not shared anymore are freed
+ */
+void plist_destroy(struct plist *self);
+
+/*
+ * Tell if the persistent list is empty
+ */
+bool plist_empty(const struct plist *self);
+
+/*
+ * Get the size of the persistent list
+ */
+size_t plist_size(const struct plist *self);
+
+/*
+ * Compare the persistent list to an array (data and size)
+ */
+bool plist_equals(const struct plist *self, const int *data, size_t size);
+
+/*
+ * Get the first element or 0 if the persistent list is empty
+ */
+int plist_front(const struct plist *self);
+
+/*
+ * New version with an element added at the beginning, in O(1)
+ */
+void plist_push_front(struct plist *self, const struct plist *other, int value);
+
+/*
+ * New version without the first element, in O(1)
+ * other is not empty
+ */
+void plist_pop_front(struct plist *self, const struct plist *other);
+
+/*
+ * New version with an element inserted at index. The nodes before index are
+ * copied and the nodes after are shared.
+ * index is valid or equals to the size of the list (insert at the end)
+ */
+void plist_insert(struct plist *self, const struct plist *other, int value, size_t index);
+
+/*
+ * New version without the element at index. The nodes before index are
+ * copied and the nodes after are shared.
+ * index is valid
+ */
+void plist_remove(struct plist *self, const struct plist *other, size_t index);
+
+/*
+ * New version with the element at index set to value. The nodes before index
+ * are copied and the nodes after are shared.
+ * index is valid
+ */
+void plist_set(struct plist *self, const struct plist *other, size_t index, int value);
+
+/*
+ * Get the element at the specified index or 0 if the index is not valid
+ */
+int plist_get(const struct plist *self, size_t index);
+
+/*
+ * Search for an element and return its index or the size of the list if not present.
+ */
+size_t plist_search(const struct plist *self, int value);
+
+/*
+ * Copy the content of the version at the end of a list
+ */
+void plist_to_list(const struct plist *self, struct list *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PERSISTENT_LIST_H
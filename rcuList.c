@@ -0,0 +1,353 @@
+#include "rcuList.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "listAtomic.h"
+
+#define RCU_CACHE_LINE 64
+#define RCU_RECLAIM_THRESHOLD 64
+
+/*
+ * Reader slot of a thread, on its own cache line. The slots are never
+ * freed before the list, a slot of an exited thread is reused.
+ */
+struct rcu_slot {
+  _Alignas(RCU_CACHE_LINE) _Atomic uint64_t epoch; // global epoch at the start of the read section, 0 outside
+  unsigned nesting; // only touched by the owner
+  bool used;        // under the registry mutex
+  struct rcu_slot *next;
+  struct rcu_list *list;
+};
+
+/*
+ * Removed node and the epoch during which it was unlinked
+ */
+struct rcu_retired {
+  struct list_node *node;
+  uint64_t epoch;
+};
+
+struct rcu_list {
+  struct list_node *first; // published with release stores
+  _Atomic uint64_t epoch;  // only advanced by the writers
+  _Atomic(struct rcu_slot *) slots;
+  pthread_key_t key;
+  pthread_mutex_t registry;
+  pthread_mutex_t writer;
+  struct rcu_retired *retired; // under the writer mutex
+  size_t retired_count;
+  size_t retired_capacity;
+};
+
+/*
+ * Reader slots
+ */
+
+static void slot_release(void *ctx) {
+  struct rcu_slot *slot = ctx;
+  atomic_store_explicit(&slot->epoch, 0, memory_order_release);
+  slot->nesting = 0;
+  pthread_mutex_lock(&slot->list->registry);
+  slot->used = false;
+  pthread_mutex_unlock(&slot->list->registry);
+}
+
+static struct rcu_slot *slot_get(struct rcu_list *self) {
+  struct rcu_slot *slot = pthread_getspecific(self->key);
+  if(slot != NULL) return slot;
+  pthread_mutex_lock(&self->registry);
+  for(slot = atomic_load_explicit(&self->slots, memory_order_relaxed); slot != NULL; slot = slot->next){
+    if(!slot->used) break;
+  }
+  if(slot == NULL){
+    slot = aligned_alloc(RCU_CACHE_LINE, sizeof(struct rcu_slot));
+    if(slot == NULL) abort(); // a reader cannot go on without a slot
+    atomic_init(&slot->epoch, 0);
+    slot->nesting = 0;
+    slot->list = self;
+    slot->next = atomic_load_explicit(&self->slots, memory_order_relaxed);
+    // the writers scan the slots without the registry mutex
+    atomic_store_explicit(&self->slots, slot, memory_order_release);
+  }
+  slot->used = true;
+  pthread_mutex_unlock(&self->registry);
+  pthread_setspecific(self->key, slot);
+  return slot;
+}
+
+void rcu_list_read_lock(struct rcu_list *self) {
+  struct rcu_slot *slot = slot_get(self);
+  if(slot->nesting++ > 0) return;
+  // acquire: a reader seeing an epoch sees the unlinks done before it
+  atomic_store_explicit(&slot->epoch, atomic_load_explicit(&self->epoch, memory_order_acquire), memory_order_relaxed);
+  // the slot is visible before any link is read, pairs with the fence of the writers
+  atomic_thread_fence(memory_order_seq_cst);
+}
+
+void rcu_list_read_unlock(struct rcu_list *self) {
+  struct rcu_slot *slot = pthread_getspecific(self->key);
+  assert(slot != NULL && slot->nesting > 0);
+  if(--slot->nesting > 0) return;
+  atomic_store_explicit(&slot->epoch, 0, memory_order_release);
+}
+
+/*
+ * Grace periods, under the writer mutex
+ */
+
+static void retire(struct rcu_list *self, struct list_node *node) {
+  if(self->retired_count == self->retired_capacity){
+    size_t capacity = self->retired_capacity == 0 ? RCU_RECLAIM_THRESHOLD : 2 * self->retired_capacity;
+    struct rcu_retired *retired = realloc(self->retired, capacity * sizeof(struct rcu_retired));
+    if(retired == NULL) abort(); // freeing now could crash a reader
+    self->retired = retired;
+    self->retired_capacity = capacity;
+  }
+  uint64_t epoch = atomic_load_explicit(&self->epoch, memory_order_relaxed);
+  self->retired[self->retired_count].node = node;
+  self->retired[self->retired_count].epoch = epoch;
+  ++self->retired_count;
+  // the readers starting from now cannot reach the node anymore
+  atomic_store_explicit(&self->epoch, epoch + 1, memory_order_release);
+}
+
+/*
+ * Free the nodes unlinked before the oldest read section in progress
+ */
+static void reclaim(struct rcu_list *self) {
+  atomic_thread_fence(memory_order_seq_cst);
+  uint64_t oldest = UINT64_MAX;
+  for(struct rcu_slot *slot = atomic_load_explicit(&self->slots, memory_order_acquire); slot != NULL; slot = slot->next){
+    uint64_t epoch = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+    if(epoch != 0 && epoch < oldest){
+      oldest = epoch;
+    }
+  }
+  size_t kept = 0;
+  for(size_t i=0; i<self->retired_count; ++i){
+    if(self->retired[i].epoch < oldest){
+      free(self->retired[i].node);
+    }
+    else{
+      self->retired[kept++] = self->retired[i];
+    }
+  }
+  self->retired_count = kept;
+}
+
+static void retire_and_reclaim(struct rcu_list *self, struct list_node *node) {
+  retire(self, node);
+  if(self->retired_count >= RCU_RECLAIM_THRESHOLD){
+    reclaim(self);
+  }
+}
+
+struct rcu_list *rcu_list_create(void) {
+  struct rcu_list *self = malloc(sizeof(struct rcu_list));
+  if(self == NULL) return NULL;
+  if(pthread_key_create(&self->key, slot_release) != 0){
+    free(self);
+    return NULL;
+  }
+  self->first = NULL;
+  atomic_init(&self->epoch, 1);
+  atomic_init(&self->slots, NULL);
+  pthread_mutex_init(&self->registry, NULL);
+  pthread_mutex_init(&self->writer, NULL);
+  self->retired = NULL;
+  self->retired_count = 0;
+  self->retired_capacity = 0;
+  return self;
+}
+
+void rcu_list_destroy(struct rcu_list *self) {
+  pthread_key_delete(self->key);
+  struct list_node *curr = self->first;
+  while(curr != NULL){
+    struct list_node *next = curr->next;
+    free(curr);
+    curr = next;
+  }
+  for(size_t i=0; i<self->retired_count; ++i){
+    free(self->retired[i].node);
+  }
+  free(self->retired);
+  struct rcu_slot *slot = atomic_load_explicit(&self->slots, memory_order_relaxed);
+  while(slot != NULL){
+    struct rcu_slot *next = slot->next;
+    free(slot);
+    slot = next;
+  }
+  pthread_mutex_destroy(&self->registry);
+  pthread_mutex_destroy(&self->writer);
+  free(self);
+}
+
+/*
+ * Readers
+ */
+
+const struct list_node *rcu_list_first(const struct rcu_list *self) {
+  return LOAD_ACQUIRE(&self->first);
+}
+
+const struct list_node *rcu_list_next(const struct list_node *node) {
+  return LOAD_ACQUIRE(&node->next);
+}
+
+size_t rcu_list_size(struct rcu_list *self) {
+  size_t size = 0;
+  rcu_list_read_lock(self);
+  for(const struct list_node *curr = rcu_list_first(self); curr != NULL; curr = rcu_list_next(curr)){
+    ++size;
+  }
+  rcu_list_read_unlock(self);
+  return size;
+}
+
+int rcu_list_get(struct rcu_list *self, size_t index) {
+  int value = 0;
+  rcu_list_read_lock(self);
+  const struct list_node *curr = rcu_list_first(self);
+  for(size_t i=0; i<index && curr != NULL; ++i){
+    curr = rcu_list_next(curr);
+  }
+  if(curr != NULL){
+    value = curr->data;
+  }
+  rcu_list_read_unlock(self);
+  return value;
+}
+
+size_t rcu_list_search(struct rcu_list *self, int value) {
+  size_t index = 0;
+  rcu_list_read_lock(self);
+  for(const struct list_node *curr = rcu_list_first(self); curr != NULL; curr = rcu_list_next(curr)){
+    if(curr->data == value) break;
+    ++index;
+  }
+  rcu_list_read_unlock(self);
+  return index;
+}
+
+void rcu_list_for_each(struct rcu_list *self, rcu_list_visitor visitor, void *ctx) {
+  rcu_list_read_lock(self);
+  for(const struct list_node *curr = rcu_list_first(self); curr != NULL; curr = rcu_list_next(curr)){
+    if(!visitor(curr->data, ctx)) break;
+  }
+  rcu_list_read_unlock(self);
+}
+
+/*
+ * Writers, the links are only written under the writer mutex, so the
+ * writers read them without atomics
+ */
+
+static struct list_node *node_create(int value, struct list_node *next) {
+  struct list_node *node = malloc(sizeof(struct list_node));
+  if(node == NULL) abort();
+  node->data = value;
+  node->next = next;
+  return node;
+}
+
+static struct list_node **link_at(struct rcu_list *self, size_t index) {
+  struct list_node **link = &self->first;
+  for(size_t i=0; i<index && *link != NULL; ++i){
+    link = &(*link)->next;
+  }
+  return link;
+}
+
+static void unlink_at(struct rcu_list *self, struct list_node **link) {
+  struct list_node *node = *link;
+  // readers on the node can still follow its next
+  STORE_RELEASE(link, node->next);
+  retire_and_reclaim(self, node);
+}
+
+void rcu_list_push_front(struct rcu_list *self, int value) {
+  rcu_list_insert(self, value, 0);
+}
+
+void rcu_list_pop_front(struct rcu_list *self) {
+  pthread_mutex_lock(&self->writer);
+  if(self->first != NULL){
+    unlink_at(self, &self->first);
+  }
+  pthread_mutex_unlock(&self->writer);
+}
+
+void rcu_list_push_back(struct rcu_list *self, int value) {
+  pthread_mutex_lock(&self->writer);
+  struct list_node **link = &self->first;
+  while(*link != NULL){
+    link = &(*link)->next;
+  }
+  STORE_RELEASE(link, node_create(value, NULL));
+  pthread_mutex_unlock(&self->writer);
+}
+
+void rcu_list_pop_back(struct rcu_list *self) {
+  pthread_mutex_lock(&self->writer);
+  if(self->first != NULL){
+    struct list_node **link = &self->first;
+    while((*link)->next != NULL){
+      link = &(*link)->next;
+    }
+    unlink_at(self, link);
+  }
+  pthread_mutex_unlock(&self->writer);
+}
+
+void rcu_list_insert(struct rcu_list *self, int value, size_t index) {
+  pthread_mutex_lock(&self->writer);
+  struct list_node **link = link_at(self, index);
+  STORE_RELEASE(link, node_create(value, *link));
+  pthread_mutex_unlock(&self->writer);
+}
+
+void rcu_list_remove(struct rcu_list *self, size_t index) {
+  pthread_mutex_lock(&self->writer);
+  struct list_node **link = link_at(self, index);
+  if(*link != NULL){
+    unlink_at(self, link);
+  }
+  pthread_mutex_unlock(&self->writer);
+}
+
+void rcu_list_set(struct rcu_list *self, size_t index, int value) {
+  pthread_mutex_lock(&self->writer);
+  struct list_node **link = link_at(self, index);
+  struct list_node *node = *link;
+  if(node != NULL){
+    // readers see either the old node or the new one, never a torn value
+    STORE_RELEASE(link, node_create(value, node->next));
+    retire_and_reclaim(self, node);
+  }
+  pthread_mutex_unlock(&self->writer);
+}
+
+void rcu_list_synchronize(struct rcu_list *self) {
+  pthread_mutex_lock(&self->writer);
+  // the readers starting after this point see no retired node
+  atomic_store_explicit(&self->epoch, atomic_load_explicit(&self->epoch, memory_order_relaxed) + 1, memory_order_release);
+  reclaim(self);
+  while(self->retired_count > 0){
+    sched_yield();
+    reclaim(self);
+  }
+  pthread_mutex_unlock(&self->writer);
+}
+
+size_t rcu_list_pending(struct rcu_list *self) {
+  pthread_mutex_lock(&self->writer);
+  size_t pending = self->retired_count;
+  pthread_mutex_unlock(&self->writer);
+  return pending;
+}
@@ -0,0 +1,87 @@
+#ifndef RCU_LIST_H
+#define RCU_LIST_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Read-mostly concurrent list (read-copy-update). Readers traverse it
+ * without locks or read-modify-write atomics: a read section only
+ * publishes the current epoch in a slot of the reading thread. Writers are
+ * serialized by a mutex, build new nodes privately and publish them with
+ * release stores; a value is changed by replacing its node. Unlinked
+ * nodes are freed once every reader that could still see them has left
+ * its read section (epoch based grace period).
+ */
+struct rcu_list;
+
+typedef bool (*rcu_list_visitor)(int value, void *ctx);
+
+/*
+ * Create an empty list, return NULL if it failed
+ */
+struct rcu_list *rcu_list_create(void);
+
+/*
+ * Destroy a list, no thread must be using it anymore
+ */
+void rcu_list_destroy(struct rcu_list *self);
+
+/*
+ * Read sections, they can be nested. Inside a read section, the nodes from
+ * rcu_list_first / rcu_list_next stay valid, even if removed meanwhile.
+ */
+void rcu_list_read_lock(struct rcu_list *self);
+void rcu_list_read_unlock(struct rcu_list *self);
+
+/*
+ * Traversal, inside a read section only
+ */
+const struct list_node *rcu_list_first(const struct rcu_list *self);
+const struct list_node *rcu_list_next(const struct list_node *node);
+
+/*
+ * Readers, each one is its own read section
+ */
+size_t rcu_list_size(struct rcu_list *self);
+int rcu_list_get(struct rcu_list *self, size_t index);
+size_t rcu_list_search(struct rcu_list *self, int value);
+
+/*
+ * Visit the values in order until the visitor returns false
+ */
+void rcu_list_for_each(struct rcu_list *self, rcu_list_visitor visitor, void *ctx);
+
+/*
+ * Writers, same contracts as the functions of linkedList.h
+ */
+void rcu_list_push_front(struct rcu_list *self, int value);
+void rcu_list_pop_front(struct rcu_list *self);
+void rcu_list_push_back(struct rcu_list *self, int value);
+void rcu_list_pop_back(struct rcu_list *self);
+void rcu_list_insert(struct rcu_list *self, int value, size_t index);
+void rcu_list_remove(struct rcu_list *self, size_t index);
+void rcu_list_set(struct rcu_list *self, size_t index, int value);
+
+/*
+ * Wait for the end of a grace period and free all the removed nodes.
+ * Must not be called inside a read section.
+ */
+void rcu_list_synchronize(struct rcu_list *self);
+
+/*
+ * Get the number of removed nodes waiting for their grace period
+ */
+size_t rcu_list_pending(struct rcu_list *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCU_LIST_H
@@ -0,0 +1,172 @@
+#include "smallList.h"
+
+#include <assert.h>
+#include <string.h>
+
+/*
+ * The inline part is full: the last inline value moves to the front of the
+ * heap part to make room for an insertion before it
+ */
+static void small_list_overflow(struct small_list *self) {
+  assert(self->inline_size == SMALL_LIST_INLINE_CAPACITY);
+  list_push_front(&self->heap, self->inline_data[SMALL_LIST_INLINE_CAPACITY - 1]);
+  --self->inline_size;
+}
+
+/*
+ * A value left the inline part: the first heap value moves back inline
+ */
+static void small_list_refill(struct small_list *self) {
+  if(list_empty(&self->heap)) return;
+  self->inline_data[self->inline_size] = self->heap.first->data;
+  ++self->inline_size;
+  list_pop_front(&self->heap);
+}
+
+void small_list_create(struct small_list *self) {
+  self->inline_size = 0;
+  list_create(&self->heap);
+}
+
+void small_list_create_from(struct small_list *self, const int *other, size_t size) {
+  small_list_create(self);
+  size_t inline_size = (size < SMALL_LIST_INLINE_CAPACITY) ? size : SMALL_LIST_INLINE_CAPACITY;
+  if(inline_size > 0){
+    memcpy(self->inline_data, other, inline_size * sizeof(int));
+  }
+  self->inline_size = inline_size;
+  if(size > inline_size){
+    list_create_from(&self->heap, other + inline_size, size - inline_size);
+  }
+}
+
+void small_list_destroy(struct small_list *self) {
+  list_destroy(&self->heap);
+  self->inline_size = 0;
+}
+
+bool small_list_spilled(const struct small_list *self) {
+  return !list_empty(&self->heap);
+}
+
+bool small_list_empty(const struct small_list *self) {
+  return self->inline_size == 0;
+}
+
+size_t small_list_size(const struct small_list *self) {
+  return self->inline_size + list_size(&self->heap);
+}
+
+bool small_list_equals(const struct small_list *self, const int *data, size_t size) {
+  if(size < self->inline_size) return false;
+  for(size_t i=0; i<self->inline_size; ++i){
+    if(self->inline_data[i] != data[i]) return false;
+  }
+  return list_equals(&self->heap, data + self->inline_size, size - self->inline_size);
+}
+
+void small_list_push_front(struct small_list *self, int value) {
+  small_list_insert(self, value, 0);
+}
+
+void small_list_pop_front(struct small_list *self) {
+  if(small_list_empty(self)) return;
+  small_list_remove(self, 0);
+}
+
+void small_list_push_back(struct small_list *self, int value) {
+  if(self->inline_size == SMALL_LIST_INLINE_CAPACITY){
+    list_push_back(&self->heap, value);
+  }
+  else{
+    self->inline_data[self->inline_size++] = value;
+  }
+}
+
+void small_list_pop_back(struct small_list *self) {
+  if(small_list_spilled(self)){
+    list_pop_back(&self->heap);
+  }
+  else if(self->inline_size > 0){
+    --self->inline_size;
+  }
+}
+
+void small_list_insert(struct small_list *self, int value, size_t index) {
+  if(index >= SMALL_LIST_INLINE_CAPACITY){
+    list_insert(&self->heap, value, index - SMALL_LIST_INLINE_CAPACITY);
+    return;
+  }
+  assert(index <= self->inline_size);
+  if(self->inline_size == SMALL_LIST_INLINE_CAPACITY){
+    small_list_overflow(self);
+  }
+  memmove(&self->inline_data[index + 1], &self->inline_data[index], (self->inline_size - index) * sizeof(int));
+  self->inline_data[index] = value;
+  ++self->inline_size;
+}
+
+void small_list_remove(struct small_list *self, size_t index) {
+  if(index >= SMALL_LIST_INLINE_CAPACITY){
+    list_remove(&self->heap, index - SMALL_LIST_INLINE_CAPACITY);
+    return;
+  }
+  assert(index < self->inline_size);
+  memmove(&self->inline_data[index], &self->inline_data[index + 1], (self->inline_size - index - 1) * sizeof(int));
+  --self->inline_size;
+  small_list_refill(self);
+}
+
+int small_list_get(const struct small_list *self, size_t index) {
+  if(index < self->inline_size) return self->inline_data[index];
+  if(index < SMALL_LIST_INLINE_CAPACITY) return 0;
+  return list_get(&self->heap, index - SMALL_LIST_INLINE_CAPACITY);
+}
+
+void small_list_set(struct small_list *self, size_t index, int value) {
+  if(index < self->inline_size){
+    self->inline_data[index] = value;
+  }
+  else if(index >= SMALL_LIST_INLINE_CAPACITY){
+    list_set(&self->heap, index - SMALL_LIST_INLINE_CAPACITY, value);
+  }
+}
+
+size_t small_list_search(const struct small_list *self, int value) {
+  for(size_t i=0; i<self->inline_size; ++i){
+    if(self->inline_data[i] == value) return i;
+  }
+  return self->inline_size + list_search(&self->heap, value);
+}
+
+bool small_list_is_sorted(const struct small_list *self) {
+  for(size_t i=1; i<self->inline_size; ++i){
+    if(self->inline_data[i-1] > self->inline_data[i]) return false;
+  }
+  if(!small_list_spilled(self)) return true;
+  return self->inline_data[self->inline_size - 1] <= self->heap.first->data && list_is_sorted(&self->heap);
+}
+
+void small_list_merge_sort(struct small_list *self) {
+  if(small_list_spilled(self)){
+    // sort everything in heap nodes, then take the smallest values back inline
+    while(self->inline_size > 0){
+      --self->inline_size;
+      list_push_front(&self->heap, self->inline_data[self->inline_size]);
+    }
+    list_merge_sort(&self->heap);
+    while(self->inline_size < SMALL_LIST_INLINE_CAPACITY){
+      small_list_refill(self);
+    }
+    return;
+  }
+  for(size_t i=1; i<self->inline_size; ++i){
+    int value = self->inline_data[i];
+    size_t j = i;
+    while(j > 0 && self->inline_data[j-1] > value){
+      self->inline_data[j] = self->inline_data[j-1];
+      --j;
+    }
+    self->inline_data[j] = value;
+  }
+}
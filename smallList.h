@@ -0,0 +1,122 @@
+#ifndef SMALL_LIST_H
+#define SMALL_LIST_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SMALL_LIST_INLINE_CAPACITY 8
+
+/*
+ * List keeping its first SMALL_LIST_INLINE_CAPACITY values inline, without
+ * any allocation. Only the values past the inline capacity are chained in
+ * heap nodes, the heap part is empty unless the inline part is full.
+ */
+struct small_list {
+  size_t inline_size;
+  int inline_data[SMALL_LIST_INLINE_CAPACITY];
+  struct list heap; // values at SMALL_LIST_INLINE_CAPACITY and after
+};
+
+/*
+ * Create an empty small list
+ */
+void small_list_create(struct small_list *self);
+
+/*
+ * Create a small list with initial content
+ */
+void small_list_create_from(struct small_list *self, const int *other, size_t size);
+
+/*
+ * Destroy a small list
+ */
+void small_list_destroy(struct small_list *self);
+
+/*
+ * Tell if some values overflowed to heap nodes
+ */
+bool small_list_spilled(const struct small_list *self);
+
+/*
+ * Tell if the small list is empty
+ */
+bool small_list_empty(const struct small_list *self);
+
+/*
+ * Get the size of the small list
+ */
+size_t small_list_size(const struct small_list *self);
+
+/*
+ * Compare the small list to an array (data and size)
+ */
+bool small_list_equals(const struct small_list *self, const int *data, size_t size);
+
+/*
+ * Add an element in the small list at the beginning
+ */
+void small_list_push_front(struct small_list *self, int value);
+
+/*
+ * Remove the element at the beginning of the small list
+ */
+void small_list_pop_front(struct small_list *self);
+
+/*
+ * Add an element in the small list at the end
+ */
+void small_list_push_back(struct small_list *self, int value);
+
+/*
+ * Remove the element at the end of the small list
+ */
+void small_list_pop_back(struct small_list *self);
+
+/*
+ * Insert an element in the small list (preserving the order)
+ * index is valid or equals to the size of the list (insert at the end)
+ */
+void small_list_insert(struct small_list *self, int value, size_t index);
+
+/*
+ * Remove an element in the small list (preserving the order)
+ * index is valid
+ */
+void small_list_remove(struct small_list *self, size_t index);
+
+/*
+ * Get the element at the specified index in the small list or 0 if the index is not valid
+ */
+int small_list_get(const struct small_list *self, size_t index);
+
+/*
+ * Set an element at the specified index in the small list to a new value, or do nothing if the index is not valid
+ */
+void small_list_set(struct small_list *self, size_t index, int value);
+
+/*
+ * Search for an element in the small list and return its index or the size of the list if not present.
+ */
+size_t small_list_search(const struct small_list *self, int value);
+
+/*
+ * Tell if a small list is sorted
+ */
+bool small_list_is_sorted(const struct small_list *self);
+
+/*
+ * Sort a small list (insertion sort inline, merge sort of all the values once spilled)
+ */
+void small_list_merge_sort(struct small_list *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMALL_LIST_H
@@ -1,11 +1,42 @@
 #include "gtest/gtest.h"
 
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
 
 #include "linkedList.h"
+#include "persistentList.h"
+#include "listQueue.h"
+#include "intrusiveList.h"
+#include "intrusiveList.hpp"
+#include "nodeArena.h"
+#include "parallelList.h"
+#include "listView.hpp"
+#include "smallList.h"
+#include "constexprList.hpp"
+#include "linkedList.hpp"
+#include "listIndex.h"
+#include "listSelect.h"
+#include "listReorder.h"
+#include "nodeCache.h"
+#include "listLog.h"
+#include "rcuList.h"
+#include "listFingerprint.h"
+#include "listCache.h"
+#include "adaptiveList.h"
 
 #define BIG_SIZE 1000
 
@@ -28,6 +59,16 @@ TEST(ListCreateTest, Empty) {
  * list_create_from
  */
 
+TEST(ListCreateFromTest, Empty) {
+  struct list l;
+  list_create_from(&l, nullptr, 0);
+
+  EXPECT_TRUE(list_empty(&l));
+  EXPECT_EQ(list_size(&l), 0u);
+
+  list_destroy(&l);
+}
+
 TEST(ListCreateFromTest, OneElement) {
   static const int origin[] = { 1 };
 
@@ -410,6 +451,27 @@ TEST(ListRemoveTest, End) {
   list_destroy(&l);
 }
 
+/*
+ * list_extract / list_insert_node
+ */
+
+TEST(ListExtractTest, MoveNode) {
+  static const int origin[] = { 9, 3, 7, 2, 4 };
+  static const int expected[] = { 9, 7, 2, 3, 4 };
+
+  struct list l;
+  list_create_from(&l, origin, std::size(origin));
+
+  struct list_node *node = list_extract(&l, 1);
+  EXPECT_EQ(node->data, 3);
+  EXPECT_EQ(list_size(&l), std::size(origin) - 1);
+
+  list_insert_node(&l, node, 3);
+  EXPECT_TRUE(list_equals(&l, expected, std::size(expected)));
+
+  list_destroy(&l);
+}
+
 /*
  * list_get
  */
@@ -704,6 +766,17 @@ TEST(ListMergeTest, SecondEmpty) {
  * list_merge_sort
  */
 
+TEST(ListMergeSortTest, Empty) {
+  struct list l;
+  list_create(&l);
+
+  list_merge_sort(&l);
+
+  EXPECT_TRUE(list_empty(&l));
+
+  list_destroy(&l);
+}
+
 TEST(ListMergeSortTest, NotSorted) {
   static const int origin[] = { 8, 4, 1, 6, 10, 3, 0, 9, 5, 2, 7 };
 
@@ -761,6 +834,2627 @@ TEST(ListMergeSortTest, Sorted) {
   list_destroy(&l);
 }
 
+/*
+ * plist
+ */
+
+TEST(PersistentListTest, PushFrontKeepsOldVersion) {
+  static const int origin[] = { 1, 2, 3 };
+  static const int expected[] = { 0, 1, 2, 3 };
+
+  struct plist v1;
+  plist_create_from(&v1, origin, std::size(origin));
+
+  struct plist v2;
+  plist_push_front(&v2, &v1, 0);
+
+  EXPECT_TRUE(plist_equals(&v1, origin, std::size(origin)));
+  EXPECT_TRUE(plist_equals(&v2, expected, std::size(expected)));
+
+  plist_destroy(&v1);
+
+  EXPECT_TRUE(plist_equals(&v2, expected, std::size(expected)));
+
+  plist_destroy(&v2);
+}
+
+TEST(PersistentListTest, PopFrontSameVersion) {
+  static const int origin[] = { 1, 2, 3 };
+  static const int expected[] = { 2, 3 };
+
+  struct plist v;
+  plist_create_from(&v, origin, std::size(origin));
+
+  struct plist snapshot;
+  plist_copy(&snapshot, &v);
+
+  plist_pop_front(&v, &v);
+
+  EXPECT_TRUE(plist_equals(&v, expected, std::size(expected)));
+  EXPECT_TRUE(plist_equals(&snapshot, origin, std::size(origin)));
+  EXPECT_EQ(plist_front(&v), 2);
+
+  plist_destroy(&snapshot);
+  plist_destroy(&v);
+}
+
+TEST(PersistentListTest, InsertRemoveSet) {
+  static const int origin[] = { 9, 3, 7, 2, 4 };
+  static const int inserted[] = { 9, 3, 42, 7, 2, 4 };
+  static const int removed[] = { 9, 3, 2, 4 };
+  static const int set[] = { 9, 3, 7, 2, 42 };
+
+  struct plist v;
+  plist_create_from(&v, origin, std::size(origin));
+
+  struct plist v1, v2, v3;
+  plist_insert(&v1, &v, 42, 2);
+  plist_remove(&v2, &v, 2);
+  plist_set(&v3, &v, 4, 42);
+
+  EXPECT_TRUE(plist_equals(&v, origin, std::size(origin)));
+  EXPECT_TRUE(plist_equals(&v1, inserted, std::size(inserted)));
+  EXPECT_TRUE(plist_equals(&v2, removed, std::size(removed)));
+  EXPECT_TRUE(plist_equals(&v3, set, std::size(set)));
+  EXPECT_EQ(plist_search(&v1, 42), 2u);
+  EXPECT_EQ(plist_search(&v2, 42), std::size(removed));
+  EXPECT_EQ(plist_get(&v3, 4), 42);
+
+  plist_destroy(&v3);
+  plist_destroy(&v2);
+  plist_destroy(&v1);
+  plist_destroy(&v);
+}
+
+TEST(PersistentListTest, ToList) {
+  static const int origin[] = { 1, 2, 3, 4 };
+
+  struct list l;
+  list_create(&l);
+
+  struct plist v;
+  plist_create_from(&v, origin, std::size(origin));
+  plist_to_list(&v, &l);
+
+  EXPECT_TRUE(list_equals(&l, origin, std::size(origin)));
+
+  struct plist w;
+  plist_create_from_list(&w, &l);
+
+  EXPECT_TRUE(plist_equals(&w, origin, std::size(origin)));
+
+  plist_destroy(&w);
+  plist_destroy(&v);
+  list_destroy(&l);
+}
+
+TEST(PersistentListTest, Stressed) {
+  struct plist v;
+  plist_create(&v);
+
+  std::vector<std::thread> readers;
+
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    plist_push_front(&v, &v, i);
+
+    if (i % 100 == 0) {
+      struct plist snapshot;
+      plist_copy(&snapshot, &v);
+      readers.emplace_back([snapshot, i]() mutable {
+        EXPECT_EQ(plist_size(&snapshot), static_cast<std::size_t>(i + 1));
+        EXPECT_EQ(plist_get(&snapshot, 0), i);
+        EXPECT_EQ(plist_search(&snapshot, 0), static_cast<std::size_t>(i));
+        plist_destroy(&snapshot);
+      });
+    }
+  }
+
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    plist_pop_front(&v, &v);
+  }
+
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_TRUE(plist_empty(&v));
+
+  plist_destroy(&v);
+}
+
+/*
+ * list_mpsc_queue
+ */
+
+static struct list_node *make_node(int value) {
+  struct list_node *node = static_cast<struct list_node *>(std::malloc(sizeof(struct list_node)));
+  node->data = value;
+  node->next = nullptr;
+  return node;
+}
+
+TEST(ListMpscQueueTest, Fifo) {
+  struct list_mpsc_queue q;
+  list_mpsc_create(&q);
+
+  EXPECT_EQ(list_mpsc_pop(&q), nullptr);
+
+  for (int i = 0; i < 10; ++i) {
+    list_mpsc_push(&q, make_node(i));
+  }
+
+  for (int i = 0; i < 10; ++i) {
+    struct list_node *node = list_mpsc_pop(&q);
+    ASSERT_NE(node, nullptr);
+    EXPECT_EQ(node->data, i);
+    std::free(node);
+  }
+
+  EXPECT_EQ(list_mpsc_pop(&q), nullptr);
+
+  list_mpsc_destroy(&q, nullptr);
+}
+
+TEST(ListMpscQueueTest, Batch) {
+  static const int origin[] = { 1, 2, 3, 4, 5 };
+  static const int expected[] = { 1, 2, 3, 4, 5, 6 };
+
+  struct list chain;
+  list_create_from(&chain, origin, std::size(origin));
+  struct list_node *last = chain.first;
+  while (last->next != nullptr) {
+    last = last->next;
+  }
+
+  struct list_mpsc_queue q;
+  list_mpsc_create(&q);
+  list_mpsc_push_chain(&q, chain.first, last);
+  list_mpsc_push(&q, make_node(6));
+
+  struct list out;
+  list_create(&out);
+
+  EXPECT_EQ(list_mpsc_pop_batch(&q, &out, 4), 4u);
+  EXPECT_EQ(list_mpsc_pop_batch(&q, &out, 10), 2u);
+  EXPECT_TRUE(list_equals(&out, expected, std::size(expected)));
+
+  list_mpsc_destroy(&q, &out);
+  list_destroy(&out);
+}
+
+TEST(ListMpscQueueTest, Stressed) {
+  static const int producers = 4;
+
+  struct list_mpsc_queue q;
+  list_mpsc_create(&q);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&q, p]() {
+      for (int i = 0; i < BIG_SIZE; ++i) {
+        list_mpsc_push(&q, make_node(p * BIG_SIZE + i));
+      }
+    });
+  }
+
+  std::vector<int> last(producers, -1);
+  int received = 0;
+  while (received < producers * BIG_SIZE) {
+    struct list_node *node = list_mpsc_pop(&q);
+    if (node == nullptr) {
+      continue;
+    }
+    int p = node->data / BIG_SIZE;
+    EXPECT_LT(last[p], node->data % BIG_SIZE);
+    last[p] = node->data % BIG_SIZE;
+    std::free(node);
+    ++received;
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(list_mpsc_pop(&q), nullptr);
+
+  list_mpsc_destroy(&q, nullptr);
+}
+
+/*
+ * list_spsc_queue
+ */
+
+TEST(ListSpscQueueTest, Full) {
+  struct list_spsc_queue q;
+  ASSERT_TRUE(list_spsc_create(&q, 3));
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(list_spsc_push(&q, make_node(i)));
+  }
+
+  struct list_node *extra = make_node(4);
+  EXPECT_FALSE(list_spsc_push(&q, extra));
+
+  struct list_node *node = list_spsc_pop(&q);
+  EXPECT_EQ(node->data, 0);
+  std::free(node);
+
+  EXPECT_TRUE(list_spsc_push(&q, extra));
+
+  static const int rest[] = { 1, 2, 3, 4 };
+  struct list out;
+  list_create(&out);
+  list_spsc_destroy(&q, &out);
+  EXPECT_TRUE(list_equals(&out, rest, std::size(rest)));
+  list_destroy(&out);
+}
+
+TEST(ListSpscQueueTest, DestroyThroughAllocator) {
+  struct list_node_arena arena;
+  list_node_arena_create(&arena, 0, 0, -1);
+  struct list out;
+  list_create_with_allocator(&out, &arena.allocator);
+
+  struct list_mpsc_queue mpsc;
+  list_mpsc_create(&mpsc);
+  struct list_spsc_queue spsc;
+  ASSERT_TRUE(list_spsc_create(&spsc, 4));
+  for (int i = 0; i < 3; ++i) {
+    list_mpsc_push(&mpsc, list_node_create(&out, i));
+    EXPECT_TRUE(list_spsc_push(&spsc, list_node_create(&out, i)));
+  }
+
+  // the nodes come from the arena, they must not reach free
+  static const int expected[] = { 0, 1, 2, 0, 1, 2 };
+  list_mpsc_destroy(&mpsc, &out);
+  list_spsc_destroy(&spsc, &out);
+  EXPECT_TRUE(list_equals(&out, expected, std::size(expected)));
+  list_destroy(&out);
+  list_node_arena_destroy(&arena);
+}
+
+TEST(ListSpscQueueTest, Batch) {
+  static const int origin[] = { 1, 2, 3, 4, 5, 6 };
+  static const int expected[] = { 1, 2, 3, 4 };
+
+  struct list chain;
+  list_create_from(&chain, origin, std::size(origin));
+
+  struct list_spsc_queue q;
+  ASSERT_TRUE(list_spsc_create(&q, 4));
+
+  EXPECT_EQ(list_spsc_push_chain(&q, &chain.first), 4u);
+  EXPECT_EQ(chain.first->data, 5);
+
+  struct list out;
+  list_create(&out);
+
+  EXPECT_EQ(list_spsc_pop_batch(&q, &out, 10), 4u);
+  EXPECT_TRUE(list_equals(&out, expected, std::size(expected)));
+  EXPECT_EQ(list_spsc_push_chain(&q, &chain.first), 2u);
+  EXPECT_EQ(chain.first, nullptr);
+
+  list_spsc_destroy(&q, &out);
+  list_destroy(&out);
+}
+
+TEST(ListSpscQueueTest, BatchSeesEverything) {
+  static const int origin[] = { 1, 2, 3, 4, 5, 6, 7 };
+  static const int expected[] = { 1, 2, 3, 4, 5, 6, 7 };
+
+  struct list chain;
+  list_create_from(&chain, origin, std::size(origin));
+  struct list out;
+  list_create(&out);
+
+  struct list_spsc_queue q;
+  ASSERT_TRUE(list_spsc_create(&q, 4));
+
+  // the cached indices are partly stale before each batch
+  EXPECT_EQ(list_spsc_push_chain(&q, &chain.first), 4u);
+  EXPECT_EQ(list_spsc_pop_batch(&q, &out, 2), 2u);
+  EXPECT_TRUE(list_spsc_push(&q, list_extract(&chain, 0)));
+  EXPECT_EQ(list_spsc_pop_batch(&q, &out, 2), 2u);
+  EXPECT_EQ(list_spsc_push_chain(&q, &chain.first), 2u);
+  EXPECT_EQ(chain.first, nullptr);
+  EXPECT_EQ(list_spsc_pop_batch(&q, &out, 10), 3u);
+  EXPECT_TRUE(list_equals(&out, expected, std::size(expected)));
+
+  list_spsc_destroy(&q, &out);
+  list_destroy(&out);
+}
+
+TEST(ListSpscQueueTest, Stressed) {
+  struct list_spsc_queue q;
+  ASSERT_TRUE(list_spsc_create(&q, 16));
+
+  std::thread producer([&q]() {
+    for (int i = 0; i < BIG_SIZE; ++i) {
+      struct list_node *node = make_node(i);
+      while (!list_spsc_push(&q, node)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    struct list_node *node;
+    while ((node = list_spsc_pop(&q)) == nullptr) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(node->data, i);
+    std::free(node);
+  }
+
+  producer.join();
+
+  list_spsc_destroy(&q, nullptr);
+}
+
+/*
+ * ilist
+ */
+
+struct pooled_item {
+  int key;
+  struct ilist_link link;
+};
+
+static int pooled_item_compare(const struct ilist_link *lhs, const struct ilist_link *rhs, void *) {
+  const pooled_item *a = ilist_entry(lhs, const pooled_item, link);
+  const pooled_item *b = ilist_entry(rhs, const pooled_item, link);
+  return (a->key > b->key) - (a->key < b->key);
+}
+
+static bool pooled_item_is(const struct ilist_link *link, void *ctx) {
+  return ilist_entry(link, const pooled_item, link)->key == *static_cast<int *>(ctx);
+}
+
+TEST(IntrusiveListTest, PushPop) {
+  pooled_item pool[4] = { { 1, {} }, { 2, {} }, { 3, {} }, { 4, {} } };
+
+  struct ilist l;
+  ilist_create(&l);
+
+  ilist_push_back(&l, &pool[1].link);
+  ilist_push_front(&l, &pool[0].link);
+  ilist_push_back(&l, &pool[3].link);
+  ilist_insert(&l, &pool[2].link, 2);
+
+  EXPECT_EQ(ilist_size(&l), 4u);
+  for (std::size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(ilist_entry(ilist_get(&l, i), pooled_item, link), &pool[i]);
+  }
+
+  EXPECT_EQ(ilist_remove(&l, 1), &pool[1].link);
+  EXPECT_EQ(ilist_pop_back(&l), &pool[3].link);
+  EXPECT_EQ(ilist_pop_front(&l), &pool[0].link);
+  EXPECT_EQ(ilist_pop_front(&l), &pool[2].link);
+  EXPECT_EQ(ilist_pop_front(&l), nullptr);
+  EXPECT_TRUE(ilist_empty(&l));
+}
+
+TEST(IntrusiveListTest, InsertRemoveAfter) {
+  pooled_item pool[3] = { { 1, {} }, { 2, {} }, { 3, {} } };
+
+  struct ilist l;
+  ilist_create(&l);
+
+  ilist_insert_after(&l, nullptr, &pool[2].link);
+  ilist_insert_after(&l, nullptr, &pool[0].link);
+  ilist_insert_after(&l, &pool[0].link, &pool[1].link);
+  for (std::size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(ilist_entry(ilist_get(&l, i), pooled_item, link), &pool[i]);
+  }
+
+  EXPECT_EQ(ilist_remove_after(&l, &pool[1].link), &pool[2].link);
+  EXPECT_EQ(ilist_remove_after(&l, nullptr), &pool[0].link);
+  EXPECT_EQ(ilist_remove_after(&l, nullptr), &pool[1].link);
+  EXPECT_TRUE(ilist_empty(&l));
+}
+
+TEST(IntrusiveListTest, SearchAndSort) {
+  static const int origin[] = { 8, 4, 1, 6, 10, 3, 0, 9, 5, 2, 7 };
+
+  pooled_item pool[std::size(origin)];
+
+  struct ilist l;
+  ilist_create(&l);
+  for (std::size_t i = 0; i < std::size(origin); ++i) {
+    pool[i].key = origin[i];
+    ilist_push_back(&l, &pool[i].link);
+  }
+
+  int key = 10;
+  EXPECT_EQ(ilist_search(&l, pooled_item_is, &key), 4u);
+  key = 42;
+  EXPECT_EQ(ilist_search(&l, pooled_item_is, &key), std::size(origin));
+
+  EXPECT_FALSE(ilist_is_sorted(&l, pooled_item_compare, nullptr));
+  ilist_merge_sort(&l, pooled_item_compare, nullptr);
+  EXPECT_TRUE(ilist_is_sorted(&l, pooled_item_compare, nullptr));
+  EXPECT_EQ(ilist_size(&l), std::size(origin));
+
+  for (std::size_t i = 0; i < std::size(origin); ++i) {
+    EXPECT_EQ(ilist_entry(ilist_get(&l, i), pooled_item, link)->key, static_cast<int>(i));
+  }
+}
+
+TEST(IntrusiveListTest, SplitMerge) {
+  pooled_item pool[7] = { { 0, {} }, { 2, {} }, { 4, {} }, { 1, {} }, { 3, {} }, { 5, {} }, { 6, {} } };
+
+  struct ilist l, l1, l2;
+  ilist_create(&l);
+  for (auto &item : pool) {
+    ilist_push_back(&l, &item.link);
+  }
+
+  ilist_split(&l, &l1, &l2);
+
+  EXPECT_TRUE(ilist_empty(&l));
+  EXPECT_EQ(ilist_size(&l1) + ilist_size(&l2), std::size(pool));
+
+  ilist_merge_sort(&l1, pooled_item_compare, nullptr);
+  ilist_merge_sort(&l2, pooled_item_compare, nullptr);
+  ilist_merge(&l, &l1, &l2, pooled_item_compare, nullptr);
+
+  EXPECT_TRUE(ilist_empty(&l1));
+  EXPECT_TRUE(ilist_empty(&l2));
+  EXPECT_TRUE(ilist_is_sorted(&l, pooled_item_compare, nullptr));
+  EXPECT_EQ(ilist_size(&l), std::size(pool));
+}
+
+TEST(IntrusiveListTest, MemberHook) {
+  struct task {
+    int priority;
+    int id;
+    ilist_link hook;
+  };
+
+  task pool[5] = { { 3, 0, {} }, { 1, 1, {} }, { 3, 2, {} }, { 0, 3, {} }, { 1, 4, {} } };
+
+  intrusive_list<task, offsetof(task, hook)> l;
+  for (auto &t : pool) {
+    l.push_back(t);
+  }
+
+  EXPECT_EQ(l.size(), std::size(pool));
+  EXPECT_EQ(l.search([](const task &t) { return t.id == 3; }), 3u);
+
+  auto by_priority = [](const task &a, const task &b) { return a.priority < b.priority; };
+  l.merge_sort(by_priority);
+  EXPECT_TRUE(l.is_sorted(by_priority));
+
+  static const int expected_ids[] = { 3, 1, 4, 0, 2 }; // stable
+  std::size_t i = 0;
+  for (const task &t : l) {
+    EXPECT_EQ(t.id, expected_ids[i++]);
+  }
+
+  EXPECT_EQ(l.pop_front(), &pool[3]);
+  EXPECT_EQ(l.remove(1), &pool[4]);
+  EXPECT_EQ(l.get(0), &pool[1]);
+  EXPECT_EQ(l.pop_back(), &pool[2]);
+}
+
+TEST(IntrusiveListTest, Stressed) {
+  std::vector<pooled_item> pool(BIG_SIZE);
+
+  struct ilist l;
+  ilist_create(&l);
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    pool[i].key = (i * 7919) % BIG_SIZE;
+    ilist_push_front(&l, &pool[i].link);
+  }
+
+  ilist_merge_sort(&l, pooled_item_compare, nullptr);
+
+  EXPECT_TRUE(ilist_is_sorted(&l, pooled_item_compare, nullptr));
+  EXPECT_EQ(ilist_size(&l), static_cast<std::size_t>(BIG_SIZE));
+}
+
+/*
+ * list_node_arena
+ */
+
+TEST(ListNodeArenaTest, ListOperations) {
+  static const int expected[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+  struct list_node_arena arena;
+  list_node_arena_create(&arena, 0, 0, -1);
+
+  struct list l;
+  list_create_with_allocator(&l, &arena.allocator);
+
+  for (int i = 9; i >= 0; --i) {
+    list_push_front(&l, i);
+  }
+  list_insert(&l, 42, 5);
+  list_remove(&l, 5);
+  list_merge_sort(&l);
+
+  EXPECT_TRUE(list_equals(&l, expected, std::size(expected)));
+
+  char *low = reinterpret_cast<char *>(l.first);
+  for (struct list_node *curr = l.first; curr != nullptr; curr = curr->next) {
+    EXPECT_LT(reinterpret_cast<char *>(curr) - low, static_cast<std::ptrdiff_t>(list_node_arena_mapped(&arena)));
+  }
+
+  list_destroy(&l);
+  list_node_arena_destroy(&arena);
+}
+
+TEST(ListNodeArenaTest, ReusesFreedNodes) {
+  struct list_node_arena arena;
+  list_node_arena_create(&arena, 0, 0, -1);
+
+  struct list l;
+  list_create_with_allocator(&l, &arena.allocator);
+
+  list_push_front(&l, 1);
+  struct list_node *first = l.first;
+  list_pop_front(&l);
+  list_push_back(&l, 2);
+
+  EXPECT_EQ(l.first, first);
+
+  list_destroy(&l);
+  list_node_arena_destroy(&arena);
+}
+
+TEST(ListNodeArenaTest, Fallback) {
+  static const unsigned all = LIST_ARENA_HUGE_PAGES | LIST_ARENA_TRANSPARENT_HUGE_PAGES | LIST_ARENA_NUMA_BIND;
+
+  struct list_node_arena arena;
+  list_node_arena_create(&arena, 1, all, 0);
+
+  EXPECT_EQ(list_node_arena_features(&arena) & ~all, 0u);
+  EXPECT_EQ(list_node_arena_mapped(&arena), LIST_ARENA_HUGE_PAGE_SIZE);
+
+  struct list l;
+  list_create_with_allocator(&l, &arena.allocator);
+
+  // more than one chunk
+  std::size_t count = 2 * LIST_ARENA_HUGE_PAGE_SIZE / sizeof(struct list_node);
+  for (std::size_t i = 0; i < count; ++i) {
+    list_push_front(&l, static_cast<int>(i));
+  }
+
+  EXPECT_EQ(list_size(&l), count);
+  EXPECT_GE(list_node_arena_mapped(&arena), 3 * LIST_ARENA_HUGE_PAGE_SIZE);
+
+  list_destroy(&l);
+  list_node_arena_destroy(&arena);
+}
+
+/*
+ * list_parallel
+ */
+
+static bool is_even(int value, void *) {
+  return value % 2 == 0;
+}
+
+static int times_three(int value, void *) {
+  return value * 3;
+}
+
+static long long max_op(long long acc, long long value, void *) {
+  return value > acc ? value : acc;
+}
+
+TEST(ListParallelTest, Empty) {
+  struct list_thread_pool *pool = list_thread_pool_create(4);
+  ASSERT_NE(pool, nullptr);
+
+  struct list l;
+  list_create(&l);
+
+  int min, max;
+  EXPECT_EQ(list_parallel_sum(&l, pool), 0);
+  EXPECT_FALSE(list_parallel_min_max(&l, pool, &min, &max));
+  EXPECT_EQ(list_parallel_count_if(&l, pool, is_even, nullptr), 0u);
+
+  list_thread_pool_destroy(pool);
+  list_destroy(&l);
+}
+
+TEST(ListParallelTest, Aggregates) {
+  struct list_thread_pool *pool = list_thread_pool_create(4);
+  ASSERT_NE(pool, nullptr);
+  EXPECT_EQ(list_thread_pool_size(pool), 4u);
+
+  struct list l;
+  list_create(&l);
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    list_push_front(&l, i - 100);
+  }
+
+  int min, max;
+  EXPECT_EQ(list_parallel_sum(&l, pool), static_cast<long long>(BIG_SIZE) * (BIG_SIZE - 1) / 2 - 100 * BIG_SIZE);
+  EXPECT_TRUE(list_parallel_min_max(&l, pool, &min, &max));
+  EXPECT_EQ(min, -100);
+  EXPECT_EQ(max, BIG_SIZE - 101);
+  EXPECT_EQ(list_parallel_reduce(&l, pool, max_op, -1000, nullptr), BIG_SIZE - 101);
+  EXPECT_EQ(list_parallel_count_if(&l, pool, is_even, nullptr), static_cast<std::size_t>(BIG_SIZE / 2));
+
+  list_thread_pool_destroy(pool);
+  list_destroy(&l);
+}
+
+TEST(ListParallelTest, Transform) {
+  static const int origin[] = { 1, 2, 3, 4, 5 };
+  static const int expected[] = { 3, 6, 9, 12, 15 };
+
+  struct list_thread_pool *pool = list_thread_pool_create(3);
+  ASSERT_NE(pool, nullptr);
+
+  struct list l;
+  list_create_from(&l, origin, std::size(origin));
+
+  list_parallel_transform(&l, pool, times_three, nullptr);
+
+  EXPECT_TRUE(list_equals(&l, expected, std::size(expected)));
+
+  list_thread_pool_destroy(pool);
+  list_destroy(&l);
+}
+
+TEST(ListParallelTest, FilterIsStable) {
+  struct list_thread_pool *pool = list_thread_pool_create(4);
+  ASSERT_NE(pool, nullptr);
+
+  std::vector<int> origin, evens, odds;
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    int value = (i * 7919) % BIG_SIZE;
+    origin.push_back(value);
+    (value % 2 == 0 ? evens : odds).push_back(value);
+  }
+
+  struct list l;
+  list_create_from(&l, origin.data(), origin.size());
+
+  static const int already[] = { 42 };
+  struct list out;
+  list_create_from(&out, already, std::size(already));
+
+  list_parallel_filter(&l, &out, pool, is_even, nullptr);
+
+  evens.insert(evens.begin(), 42);
+  EXPECT_TRUE(list_equals(&l, odds.data(), odds.size()));
+  EXPECT_TRUE(list_equals(&out, evens.data(), evens.size()));
+
+  list_thread_pool_destroy(pool);
+  list_destroy(&out);
+  list_destroy(&l);
+}
+
+/*
+ * list_views
+ */
+
+TEST(ListViewTest, FusedPipeline) {
+  static const int origin[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+  struct list l;
+  list_create_from(&l, origin, std::size(origin));
+
+  int calls = 0;
+  auto view = list_views::all(l)
+    | list_views::filter([](int value) { return value % 2 == 0; })
+    | list_views::transform([&calls](int value) { ++calls; return value * 10; })
+    | list_views::take(3);
+
+  EXPECT_EQ(calls, 0); // lazy
+
+  EXPECT_EQ(list_views::reduce(view, 0LL, std::plus<>()), 20 + 40 + 60);
+  EXPECT_EQ(calls, 3); // take stops the traversal
+
+  std::vector<int> values;
+  for (int value : view) {
+    values.push_back(value);
+  }
+  EXPECT_EQ(values, (std::vector<int>{ 20, 40, 60 }));
+
+  list_destroy(&l);
+}
+
+TEST(ListViewTest, TakeDrop) {
+  static const int origin[] = { 1, 2, 3, 4, 5, 6 };
+
+  struct list l;
+  list_create_from(&l, origin, std::size(origin));
+
+  EXPECT_EQ(list_views::to_vector(list_views::all(l) | list_views::drop(2) | list_views::take(3)), (std::vector<int>{ 3, 4, 5 }));
+  EXPECT_TRUE(list_views::to_vector(list_views::all(l) | list_views::drop(10)).empty());
+  EXPECT_EQ(list_views::to_vector(list_views::all(l) | list_views::take(10)).size(), std::size(origin));
+
+  list_destroy(&l);
+}
+
+TEST(ListViewTest, ZipMerge) {
+  static const int origin1[] = { 0, 1, 3, 6, 10 };
+  static const int origin2[] = { 2, 4, 5, 7, 8, 9 };
+  static const int expected[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+  struct list l1, l2;
+  list_create_from(&l1, origin1, std::size(origin1));
+  list_create_from(&l2, origin2, std::size(origin2));
+
+  auto products = list_views::zip(list_views::all(l1), list_views::all(l2))
+    | list_views::transform([](std::pair<int, int> p) { return p.first * p.second; });
+  EXPECT_EQ(list_views::reduce(products, 0, std::plus<>()), 0 * 2 + 1 * 4 + 3 * 5 + 6 * 7 + 10 * 8);
+
+  struct list out;
+  list_create(&out);
+  list_views::to_list(list_views::merge(list_views::all(l1), list_views::all(l2)), out);
+
+  EXPECT_TRUE(list_equals(&out, expected, std::size(expected)));
+  EXPECT_TRUE(list_equals(&l1, origin1, std::size(origin1)));
+
+  int array[4];
+  EXPECT_EQ(list_views::to_array(list_views::all(out) | list_views::drop(8), array, std::size(array)), 3u);
+  EXPECT_EQ(array[0], 8);
+  EXPECT_EQ(array[2], 10);
+
+  list_destroy(&out);
+  list_destroy(&l2);
+  list_destroy(&l1);
+}
+
+/*
+ * small_list
+ */
+
+TEST(SmallListTest, Inline) {
+  static const int expected[] = { 0, 1, 42, 2, 3 };
+
+  struct small_list l;
+  small_list_create(&l);
+
+  small_list_push_back(&l, 2);
+  small_list_push_back(&l, 3);
+  small_list_push_front(&l, 1);
+  small_list_push_front(&l, 0);
+  small_list_insert(&l, 42, 2);
+
+  EXPECT_FALSE(small_list_spilled(&l));
+  EXPECT_EQ(small_list_size(&l), std::size(expected));
+  EXPECT_TRUE(small_list_equals(&l, expected, std::size(expected)));
+  EXPECT_EQ(small_list_search(&l, 42), 2u);
+  EXPECT_EQ(small_list_get(&l, 10), 0);
+
+  small_list_remove(&l, 2);
+  small_list_set(&l, 0, 7);
+  EXPECT_FALSE(small_list_is_sorted(&l));
+  small_list_merge_sort(&l);
+  EXPECT_TRUE(small_list_is_sorted(&l));
+
+  static const int sorted[] = { 1, 2, 3, 7 };
+  EXPECT_TRUE(small_list_equals(&l, sorted, std::size(sorted)));
+
+  small_list_destroy(&l);
+}
+
+TEST(SmallListTest, Spill) {
+  struct small_list l;
+  small_list_create(&l);
+
+  for (int i = 0; i < SMALL_LIST_INLINE_CAPACITY; ++i) {
+    small_list_push_back(&l, i);
+  }
+  EXPECT_FALSE(small_list_spilled(&l));
+
+  small_list_push_front(&l, -1);
+  EXPECT_TRUE(small_list_spilled(&l));
+  EXPECT_EQ(small_list_size(&l), static_cast<std::size_t>(SMALL_LIST_INLINE_CAPACITY + 1));
+
+  for (int i = -1; i < SMALL_LIST_INLINE_CAPACITY; ++i) {
+    EXPECT_EQ(small_list_get(&l, i + 1), i);
+  }
+
+  while (!small_list_empty(&l)) {
+    small_list_pop_front(&l);
+  }
+  EXPECT_FALSE(small_list_spilled(&l));
+
+  small_list_destroy(&l);
+}
+
+TEST(SmallListTest, OnlyOverflowInHeap) {
+  struct small_list l;
+  small_list_create(&l);
+  for (int i = 0; i < SMALL_LIST_INLINE_CAPACITY + 2; ++i) {
+    small_list_push_back(&l, i);
+  }
+  EXPECT_EQ(l.inline_size, static_cast<std::size_t>(SMALL_LIST_INLINE_CAPACITY));
+  EXPECT_EQ(list_size(&l.heap), 2u);
+
+  small_list_push_front(&l, -1); // the last inline value moves to the heap part
+  EXPECT_EQ(list_size(&l.heap), 3u);
+  EXPECT_EQ(l.inline_data[0], -1);
+  EXPECT_EQ(small_list_get(&l, SMALL_LIST_INLINE_CAPACITY), SMALL_LIST_INLINE_CAPACITY - 1);
+
+  small_list_remove(&l, 0); // and comes back
+  small_list_remove(&l, 0);
+  EXPECT_EQ(list_size(&l.heap), 1u);
+  EXPECT_EQ(small_list_get(&l, SMALL_LIST_INLINE_CAPACITY - 1), SMALL_LIST_INLINE_CAPACITY);
+
+  small_list_set(&l, 0, 100);
+  small_list_merge_sort(&l);
+  EXPECT_TRUE(small_list_is_sorted(&l));
+  EXPECT_EQ(small_list_get(&l, SMALL_LIST_INLINE_CAPACITY), 100);
+  EXPECT_EQ(list_size(&l.heap), 1u);
+
+  small_list_pop_back(&l);
+  EXPECT_FALSE(small_list_spilled(&l));
+  EXPECT_EQ(small_list_size(&l), static_cast<std::size_t>(SMALL_LIST_INLINE_CAPACITY));
+  small_list_destroy(&l);
+}
+
+TEST(SmallListTest, Stressed) {
+  std::vector<int> model;
+  struct small_list l;
+  small_list_create(&l);
+
+  unsigned state = 12345;
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    state = state * 1103515245 + 12345;
+    unsigned r = state >> 16;
+    int value = static_cast<int>(r % 100);
+    switch (r % 5) {
+    case 0:
+    case 1:
+      if (model.size() < 20) {
+        std::size_t index = r % (model.size() + 1);
+        small_list_insert(&l, value, index);
+        model.insert(model.begin() + index, value);
+      }
+      break;
+    case 2:
+      if (!model.empty()) {
+        std::size_t index = r % model.size();
+        small_list_remove(&l, index);
+        model.erase(model.begin() + index);
+      }
+      break;
+    case 3:
+      small_list_pop_back(&l);
+      if (!model.empty()) {
+        model.pop_back();
+      }
+      break;
+    case 4:
+      EXPECT_EQ(small_list_search(&l, value), static_cast<std::size_t>(std::find(model.begin(), model.end(), value) - model.begin()));
+      break;
+    }
+    ASSERT_TRUE(small_list_equals(&l, model.data(), model.size()));
+  }
+
+  small_list_destroy(&l);
+}
+
+TEST(SmallListTest, CreateFrom) {
+  static const int few[] = { 1, 2, 3 };
+  static const int many[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+  struct small_list l1, l2;
+  small_list_create_from(&l1, few, std::size(few));
+  small_list_create_from(&l2, many, std::size(many));
+
+  EXPECT_FALSE(small_list_spilled(&l1));
+  EXPECT_TRUE(small_list_spilled(&l2));
+  EXPECT_TRUE(small_list_equals(&l1, few, std::size(few)));
+  EXPECT_TRUE(small_list_equals(&l2, many, std::size(many)));
+
+  small_list_destroy(&l2);
+  small_list_destroy(&l1);
+}
+
+/*
+ * constexpr_list
+ */
+
+static constexpr int lookup_origin[] = { 8, 4, 1, 6, 10, 3, 0, 9, 5, 2, 7 };
+static constexpr auto lookup_table = make_constexpr_list(lookup_origin).merge_sorted();
+
+static_assert(!make_constexpr_list(lookup_origin).is_sorted());
+static_assert(lookup_table.is_sorted());
+static_assert(lookup_table.size() == std::size(lookup_origin));
+static_assert(lookup_table.get(0) == 0 && lookup_table.get(10) == 10);
+static_assert(lookup_table.search(7) == 7);
+static_assert(lookup_table.search(42) == std::size(lookup_origin));
+
+static constexpr auto built_table = []() {
+  constexpr_list<3> l;
+  l.push_front(3);
+  l.push_front(1);
+  l.push_front(2);
+  l.merge_sort();
+  return l;
+}();
+
+static constexpr constexpr_list<0> empty_table;
+
+TEST(ConstexprListTest, StaticList) {
+  static const int expected[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+  const struct list *l = &static_list<lookup_table>::list;
+
+  EXPECT_EQ(list_size(l), std::size(expected));
+  EXPECT_TRUE(list_is_sorted(l));
+  EXPECT_TRUE(list_equals(l, expected, std::size(expected)));
+  EXPECT_EQ(list_get(l, 4), 4);
+  EXPECT_EQ(list_search(l, 9), 9u);
+}
+
+TEST(ConstexprListTest, PushFront) {
+  static const int expected[] = { 1, 2, 3 };
+
+  EXPECT_TRUE(list_equals(&static_list<built_table>::list, expected, std::size(expected)));
+}
+
+TEST(ConstexprListTest, Empty) {
+  EXPECT_TRUE(list_empty(&static_list<empty_table>::list));
+  EXPECT_TRUE(empty_table.is_sorted());
+  EXPECT_EQ(empty_table.get(0), 0);
+}
+
+/*
+ * linked_list
+ */
+
+TEST(LinkedListTest, MoveStealsNodes) {
+  static const int expected[] = { 1, 2, 3 };
+
+  linked_list l1 = { 1, 2, 3 };
+  const struct list_node *first = l1.c_list()->first;
+
+  linked_list l2(std::move(l1));
+  EXPECT_TRUE(l1.empty());
+  EXPECT_EQ(l2.c_list()->first, first);
+  EXPECT_TRUE(l2.equals(expected, std::size(expected)));
+
+  linked_list l3;
+  l3.push_back(42);
+  l3 = std::move(l2);
+  EXPECT_TRUE(l2.empty());
+  EXPECT_EQ(l3.c_list()->first, first);
+}
+
+TEST(LinkedListTest, Clone) {
+  linked_list l1 = { 4, 5, 6 };
+  linked_list l2 = l1.clone();
+
+  EXPECT_TRUE(l1 == l2);
+  EXPECT_NE(l1.c_list()->first, l2.c_list()->first);
+
+  l2.set(0, 0);
+  EXPECT_TRUE(l1 != l2);
+  EXPECT_EQ(l1.get(0), 4);
+}
+
+TEST(LinkedListTest, Emplace) {
+  static const int expected[] = { 0, 1, 2, 30 };
+
+  linked_list l;
+  l.emplace_back(1);
+  l.emplace_front(0);
+  auto last = l.emplace_back(3);
+  last *= 10;
+  l.insert(2, 2);
+
+  EXPECT_TRUE(l.equals(expected, std::size(expected)));
+}
+
+TEST(LinkedListTest, NodeHandle) {
+  static const int expected1[] = { 1, 3 };
+  static const int expected2[] = { 2, 10, 20 };
+
+  linked_list l1 = { 1, 2, 3 };
+  linked_list l2 = { 10, 20 };
+
+  linked_list::node_handle handle = l1.extract(1);
+  struct list_node *node = l2.c_list()->first;
+  ASSERT_TRUE(handle);
+  EXPECT_EQ(handle.value(), 2);
+
+  l2.push_front(std::move(handle));
+  EXPECT_TRUE(handle.empty());
+  EXPECT_EQ(l2.c_list()->first->next, node); // relinked, not copied
+
+  EXPECT_TRUE(l1.equals(expected1, std::size(expected1)));
+  EXPECT_TRUE(l2.equals(expected2, std::size(expected2)));
+
+  linked_list::node_handle dropped = l2.extract(2); // freed by the handle
+  EXPECT_EQ(dropped.value(), 20);
+}
+
+TEST(LinkedListTest, NodeHandleOtherAllocator) {
+  static const int expected[] = { 1, 2 };
+
+  struct list_node_arena arena;
+  list_node_arena_create(&arena, 0, 0, -1);
+
+  {
+    linked_list from_arena(&arena.allocator);
+    from_arena.push_back(2);
+
+    linked_list from_malloc = { 1 };
+    from_malloc.push_back(from_arena.extract(0));
+
+    EXPECT_TRUE(from_malloc.equals(expected, std::size(expected)));
+    EXPECT_TRUE(from_arena.empty());
+  }
+
+  list_node_arena_destroy(&arena);
+}
+
+/*
+ * list_index
+ */
+
+static void expect_index_matches(const struct list *l, const std::vector<int> &values) {
+  for (int value = -5; value < 40; ++value) {
+    auto it = std::find(values.begin(), values.end(), value);
+    std::size_t position = 0;
+    struct list_node *node = nullptr;
+    bool found = list_index_find(l, value, &position, &node);
+    EXPECT_EQ(found, it != values.end());
+    if (found) {
+      EXPECT_EQ(position, std::size_t(it - values.begin()));
+      EXPECT_EQ(node->data, value);
+    }
+    EXPECT_EQ(list_search(l, value), std::size_t(it - values.begin()));
+  }
+}
+
+TEST(ListIndexTest, AttachExisting) {
+  static const int data[] = { 4, 8, 4, 15, 16, 23, 42 };
+  struct list l;
+  list_create_from(&l, data, std::size(data));
+
+  EXPECT_FALSE(list_index_find(&l, 4, nullptr, nullptr));
+  EXPECT_FALSE(list_index_usable(&l));
+  EXPECT_EQ(list_index_memory(&l), 0u);
+  ASSERT_TRUE(list_index_attach(&l));
+  EXPECT_TRUE(list_index_usable(&l));
+  EXPECT_GT(list_index_memory(&l), 0u);
+
+  std::size_t position = 0;
+  struct list_node *node = nullptr;
+  EXPECT_TRUE(list_index_find(&l, 15, &position, &node));
+  EXPECT_EQ(position, 3u);
+  EXPECT_EQ(node, l.first->next->next->next);
+  EXPECT_TRUE(list_index_find(&l, 4, &position, nullptr));
+  EXPECT_EQ(position, 0u);
+  EXPECT_EQ(list_search(&l, 1), std::size(data));
+
+  list_index_detach(&l);
+  EXPECT_EQ(list_search(&l, 42), 6u);
+  list_destroy(&l);
+}
+
+TEST(ListIndexTest, Duplicates) {
+  struct list l;
+  list_create(&l);
+  ASSERT_TRUE(list_index_attach(&l));
+  std::vector<int> values;
+
+  for (int i = 0; i < 6; ++i) {
+    list_push_back(&l, 1);
+    values.push_back(1);
+    list_push_back(&l, 2);
+    values.push_back(2);
+  }
+  expect_index_matches(&l, values);
+
+  // removing the first occurrence moves to the next one
+  list_remove(&l, 1);
+  values.erase(values.begin() + 1);
+  expect_index_matches(&l, values);
+  list_pop_front(&l);
+  values.erase(values.begin());
+  expect_index_matches(&l, values);
+
+  // an earlier occurrence takes over
+  list_insert(&l, 2, 0);
+  values.insert(values.begin(), 2);
+  expect_index_matches(&l, values);
+  list_set(&l, 0, 3);
+  values[0] = 3;
+  expect_index_matches(&l, values);
+
+  while (!list_empty(&l)) {
+    list_pop_back(&l);
+    values.pop_back();
+    expect_index_matches(&l, values);
+  }
+  list_destroy(&l);
+}
+
+TEST(ListIndexTest, Random) {
+  struct list l;
+  list_create(&l);
+  ASSERT_TRUE(list_index_attach(&l));
+  std::vector<int> values;
+
+  std::srand(36);
+  for (int i = 0; i < 3000; ++i) {
+    int value = std::rand() % 32;
+    std::size_t size = values.size();
+    switch (std::rand() % 8) {
+    case 0:
+      list_push_front(&l, value);
+      values.insert(values.begin(), value);
+      break;
+    case 1:
+      list_push_back(&l, value);
+      values.push_back(value);
+      break;
+    case 2: {
+      std::size_t index = std::rand() % (size + 1);
+      list_insert(&l, value, index);
+      values.insert(values.begin() + index, value);
+      break;
+    }
+    case 3:
+      if (size > 0) {
+        std::size_t index = std::rand() % size;
+        list_remove(&l, index);
+        values.erase(values.begin() + index);
+      }
+      break;
+    case 4:
+      if (size > 0) {
+        std::size_t index = std::rand() % size;
+        list_set(&l, index, value);
+        values[index] = value;
+      }
+      break;
+    case 5:
+      list_pop_front(&l);
+      if (size > 0) {
+        values.erase(values.begin());
+      }
+      break;
+    case 6:
+      list_pop_back(&l);
+      if (size > 0) {
+        values.pop_back();
+      }
+      break;
+    default:
+      if (size > 0) {
+        std::size_t from = std::rand() % size;
+        std::size_t to = std::rand() % size;
+        list_insert_node(&l, list_extract(&l, from), to);
+        int moved = values[from];
+        values.erase(values.begin() + from);
+        values.insert(values.begin() + to, moved);
+      }
+      break;
+    }
+    if (i % 100 == 0) {
+      expect_index_matches(&l, values);
+    }
+  }
+  expect_index_matches(&l, values);
+
+  list_merge_sort(&l);
+  std::sort(values.begin(), values.end());
+  expect_index_matches(&l, values);
+
+  list_destroy(&l);
+  EXPECT_EQ(list_index_memory(&l), 0u);
+}
+
+TEST(ListIndexTest, Growth) {
+  struct list l;
+  list_create(&l);
+  ASSERT_TRUE(list_index_attach(&l));
+  std::size_t initial = list_index_memory(&l);
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    list_push_front(&l, i);
+  }
+  EXPECT_GT(list_index_memory(&l), initial);
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    EXPECT_EQ(list_search(&l, i), std::size_t(BIG_SIZE - 1 - i));
+  }
+  list_destroy(&l);
+}
+
+TEST(ListIndexTest, InsertsNearFront) {
+  struct list l;
+  list_create(&l);
+  ASSERT_TRUE(list_index_attach(&l));
+  std::vector<int> values;
+  for (int i = 0; i < 1000; ++i) {
+    list_push_back(&l, i);
+    values.push_back(i);
+  }
+
+  // many pending shifts, some entries touched between them
+  std::srand(36);
+  for (int i = 0; i < 2000; ++i) {
+    std::size_t index = 1 + std::rand() % 8;
+    if (i % 3 == 2) {
+      list_remove(&l, index);
+      values.erase(values.begin() + index);
+    } else {
+      int value = 1000 + std::rand() % 40;
+      list_insert(&l, value, index);
+      values.insert(values.begin() + index, value);
+    }
+    if (i % 7 == 0) {
+      int key = std::rand() % 1040;
+      EXPECT_EQ(list_search(&l, key), std::size_t(std::find(values.begin(), values.end(), key) - values.begin()));
+    }
+  }
+  for (int key = 0; key < 1040; ++key) {
+    EXPECT_EQ(list_search(&l, key), std::size_t(std::find(values.begin(), values.end(), key) - values.begin()));
+  }
+  list_destroy(&l);
+}
+
+TEST(ListIndexTest, HandLinked) {
+  struct list l;
+  list_create(&l);
+  ASSERT_TRUE(list_index_attach(&l));
+  list_push_back(&l, 1);
+
+  // the wrappers linking nodes themselves keep the index up to date
+  linked_list wrapped = linked_list::adopt(l);
+  wrapped.push_back(2);
+  wrapped.push_back(wrapped.extract(0));
+  EXPECT_EQ(wrapped.search(1), 1u);
+  EXPECT_EQ(wrapped.search(2), 0u);
+
+  *wrapped.begin() = 3;
+  EXPECT_EQ(wrapped.search(3), 0u);
+  EXPECT_EQ(wrapped.search(2), 2u);
+}
+
+TEST(ListIndexTest, WrapperWrites) {
+  linked_list l = { 1, 2, 3 };
+  ASSERT_TRUE(list_index_attach(l.c_list()));
+  ASSERT_TRUE(list_fingerprint_attach(l.c_list()));
+
+  for (auto value : l) {
+    value += 10;
+  }
+  static const int expected[] = { 11, 12, 13 };
+  EXPECT_TRUE(l.equals(expected, std::size(expected)));
+  EXPECT_EQ(l.search(11), 0u);
+  EXPECT_EQ(l.search(13), 2u);
+  EXPECT_EQ(l.search(1), 3u);
+  EXPECT_EQ(list_fingerprint_hash(l.c_list()), list_fingerprint_array(expected, std::size(expected)));
+
+  auto first = l.emplace_front(5);
+  auto last = l.emplace_back(6);
+  first = 7;
+  last *= 2;
+  static const int emplaced[] = { 7, 11, 12, 13, 12 };
+  EXPECT_EQ(l.search(7), 0u);
+  EXPECT_EQ(l.search(12), 2u);
+  EXPECT_EQ(l.search(5), 5u);
+  EXPECT_EQ(list_fingerprint_hash(l.c_list()), list_fingerprint_array(emplaced, std::size(emplaced)));
+  int min = 0;
+  int max = 0;
+  EXPECT_TRUE(list_min_max(l.c_list(), &min, &max));
+  EXPECT_EQ(min, 7);
+  EXPECT_EQ(max, 13);
+}
+
+TEST(ListIndexTest, WrapperWritesAfterInsertions) {
+  linked_list l = { 1, 2, 3 };
+  ASSERT_TRUE(list_index_attach(l.c_list()));
+  ASSERT_TRUE(list_fingerprint_attach(l.c_list()));
+
+  auto it = l.begin();
+  ++it;
+  auto last = l.emplace_back(4);
+  l.push_front(0);
+  l.insert(2, 9);
+  *it = 20;
+  last = 40;
+
+  static const int expected[] = { 0, 1, 9, 20, 3, 40 };
+  EXPECT_TRUE(l.equals(expected, std::size(expected)));
+  EXPECT_EQ(l.search(20), 3u);
+  EXPECT_EQ(l.search(40), 5u);
+  EXPECT_EQ(l.search(2), 6u);
+  linked_list same = { 0, 1, 9, 20, 3, 40 };
+  ASSERT_TRUE(list_fingerprint_attach(same.c_list()));
+  EXPECT_TRUE(list_equals_list(l.c_list(), same.c_list()));
+  EXPECT_EQ(list_fingerprint_hash(l.c_list()), list_fingerprint_array(expected, std::size(expected)));
+}
+
+/*
+ * list_select
+ */
+
+static std::vector<int> list_values(const struct list *l) {
+  std::vector<int> values;
+  for (struct list_node *curr = l->first; curr != nullptr; curr = curr->next) {
+    values.push_back(curr->data);
+  }
+  return values;
+}
+
+static std::vector<std::vector<int>> select_inputs() {
+  std::vector<std::vector<int>> inputs = { { 7 }, { 2, 1 }, { 3, 3, 3, 3 } };
+  std::vector<int> sorted(BIG_SIZE);
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    sorted[i] = i;
+  }
+  inputs.push_back(sorted);
+  inputs.push_back(std::vector<int>(sorted.rbegin(), sorted.rend()));
+  std::srand(37);
+  std::vector<int> random(BIG_SIZE);
+  for (auto &value : random) {
+    value = std::rand() % 100;
+  }
+  inputs.push_back(random);
+  return inputs;
+}
+
+TEST(ListSelectTest, NthElement) {
+  for (const auto &input : select_inputs()) {
+    std::vector<int> sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t index : { std::size_t(0), input.size() / 2, input.size() - 1 }) {
+      struct list l;
+      list_create_from(&l, input.data(), input.size());
+      EXPECT_EQ(list_nth_element(&l, index), sorted[index]);
+      std::vector<int> values = list_values(&l);
+      ASSERT_EQ(values.size(), input.size());
+      EXPECT_EQ(values[index], sorted[index]);
+      for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_TRUE(i < index ? values[i] <= values[index] : values[i] >= values[index]);
+      }
+      EXPECT_TRUE(std::is_permutation(values.begin(), values.end(), input.begin()));
+      list_destroy(&l);
+    }
+  }
+}
+
+TEST(ListSelectTest, NthElementKeepsNodes) {
+  static const int data[] = { 5, 1, 4, 2, 3 };
+  struct list l;
+  list_create_from(&l, data, std::size(data));
+  std::vector<struct list_node *> before;
+  for (struct list_node *curr = l.first; curr != nullptr; curr = curr->next) {
+    before.push_back(curr);
+  }
+
+  EXPECT_EQ(list_nth_element(&l, 2), 3);
+  std::vector<struct list_node *> after;
+  for (struct list_node *curr = l.first; curr != nullptr; curr = curr->next) {
+    after.push_back(curr);
+  }
+  EXPECT_TRUE(std::is_permutation(after.begin(), after.end(), before.begin()));
+  list_destroy(&l);
+}
+
+TEST(ListSelectTest, PartialSort) {
+  for (const auto &input : select_inputs()) {
+    std::vector<int> sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t k : { std::size_t(0), std::size_t(1), std::size_t(10), input.size(), input.size() + 1 }) {
+      struct list l;
+      list_create_from(&l, input.data(), input.size());
+      list_partial_sort(&l, k);
+      std::vector<int> values = list_values(&l);
+      ASSERT_EQ(values.size(), input.size());
+      std::size_t prefix = std::min(k, input.size());
+      EXPECT_TRUE(std::equal(values.begin(), values.begin() + prefix, sorted.begin()));
+      EXPECT_TRUE(std::is_permutation(values.begin(), values.end(), input.begin()));
+      list_destroy(&l);
+    }
+  }
+}
+
+TEST(ListSelectTest, TopK) {
+  for (const auto &input : select_inputs()) {
+    std::vector<int> sorted = input;
+    std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+    struct list l;
+    list_create_from(&l, input.data(), input.size());
+    for (std::size_t k : { std::size_t(1), std::size_t(3), std::size_t(100), input.size() + 5 }) {
+      std::vector<int> out(k);
+      std::size_t count = list_top_k(&l, out.data(), k);
+      ASSERT_EQ(count, std::min(k, input.size()));
+      EXPECT_TRUE(std::equal(out.begin(), out.begin() + count, sorted.begin()));
+    }
+    EXPECT_EQ(list_top_k(&l, nullptr, 0), 0u);
+    EXPECT_TRUE(list_equals(&l, input.data(), input.size()));
+    list_destroy(&l);
+  }
+}
+
+TEST(ListSelectTest, Indexed) {
+  static const int data[] = { 9, 8, 7, 6, 5 };
+  struct list l;
+  list_create_from(&l, data, std::size(data));
+  list_index_attach(&l);
+  list_partial_sort(&l, 2);
+  EXPECT_EQ(list_search(&l, 5), 0u);
+  EXPECT_EQ(list_search(&l, 6), 1u);
+  list_destroy(&l);
+}
+
+/*
+ * list_reorder
+ */
+
+static std::vector<struct list_node *> list_nodes(const struct list *l) {
+  std::vector<struct list_node *> nodes;
+  for (struct list_node *curr = l->first; curr != nullptr; curr = curr->next) {
+    nodes.push_back(curr);
+  }
+  return nodes;
+}
+
+TEST(ListReorderTest, Reverse) {
+  static const int data[] = { 1, 2, 3, 4 };
+  static const int expected[] = { 4, 3, 2, 1 };
+  struct list l;
+  list_create(&l);
+  list_reverse(&l);
+  EXPECT_TRUE(list_empty(&l));
+
+  list_destroy(&l);
+  list_create_from(&l, data, std::size(data));
+  std::vector<struct list_node *> nodes = list_nodes(&l);
+  list_reverse(&l);
+  EXPECT_TRUE(list_equals(&l, expected, std::size(expected)));
+  std::reverse(nodes.begin(), nodes.end());
+  EXPECT_EQ(list_nodes(&l), nodes);
+  list_destroy(&l);
+}
+
+TEST(ListReorderTest, Rotate) {
+  static const int data[] = { 1, 2, 3, 4, 5 };
+  struct list l;
+  list_create(&l);
+  list_rotate(&l, 3);
+  EXPECT_TRUE(list_empty(&l));
+  list_destroy(&l);
+
+  for (std::size_t k = 0; k < 12; ++k) {
+    std::vector<int> expected(std::begin(data), std::end(data));
+    std::rotate(expected.begin(), expected.begin() + k % expected.size(), expected.end());
+    list_create_from(&l, data, std::size(data));
+    list_rotate(&l, k);
+    EXPECT_TRUE(list_equals(&l, expected.data(), expected.size()));
+    list_destroy(&l);
+  }
+}
+
+static bool is_odd(int value, void *) {
+  return value % 2 != 0;
+}
+
+TEST(ListReorderTest, StablePartition) {
+  static const int data[] = { 4, 1, 6, 3, 8, 5, 7 };
+  static const int expected[] = { 1, 3, 5, 7, 4, 6, 8 };
+  struct list l;
+  list_create_from(&l, data, std::size(data));
+  EXPECT_EQ(list_stable_partition(&l, is_odd, nullptr), 4u);
+  EXPECT_TRUE(list_equals(&l, expected, std::size(expected)));
+  EXPECT_EQ(list_stable_partition(&l, is_odd, nullptr), 4u);
+  EXPECT_TRUE(list_equals(&l, expected, std::size(expected)));
+  list_destroy(&l);
+
+  list_create(&l);
+  EXPECT_EQ(list_stable_partition(&l, is_odd, nullptr), 0u);
+  list_destroy(&l);
+}
+
+TEST(ListReorderTest, Shuffle) {
+  std::vector<int> data(BIG_SIZE);
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    data[i] = i;
+  }
+  struct list l;
+  list_create_from(&l, data.data(), data.size());
+  std::vector<struct list_node *> nodes = list_nodes(&l);
+  list_shuffle(&l, 38);
+  EXPECT_FALSE(list_is_sorted(&l));
+  std::vector<struct list_node *> shuffled = list_nodes(&l);
+  EXPECT_TRUE(std::is_permutation(shuffled.begin(), shuffled.end(), nodes.begin()));
+  list_destroy(&l);
+}
+
+TEST(ListReorderTest, ShuffleUniform) {
+  static const int data[] = { 0, 1, 2 };
+  const int trials = 6000;
+  int counts[3][3] = {};
+  for (int seed = 0; seed < trials; ++seed) {
+    struct list l;
+    list_create_from(&l, data, std::size(data));
+    list_shuffle(&l, seed);
+    int position = 0;
+    for (struct list_node *curr = l.first; curr != nullptr; curr = curr->next) {
+      ++counts[curr->data][position++];
+    }
+    list_destroy(&l);
+  }
+  // each value lands at each position a third of the time
+  for (auto &row : counts) {
+    for (int count : row) {
+      EXPECT_NEAR(count, trials / 3, trials / 30);
+    }
+  }
+}
+
+TEST(ListReorderTest, Indexed) {
+  static const int data[] = { 1, 2, 3 };
+  struct list l;
+  list_create_from(&l, data, std::size(data));
+  list_index_attach(&l);
+  list_reverse(&l);
+  EXPECT_EQ(list_search(&l, 1), 2u);
+  list_rotate(&l, 1);
+  EXPECT_EQ(list_search(&l, 3), 2u);
+  list_destroy(&l);
+}
+
+/*
+ * list_node_cache
+ */
+
+TEST(NodeCacheTest, SingleThread) {
+  struct list_node_cache *cache = list_node_cache_create(0, 0);
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(list_node_cache_memory(cache), 0u);
+
+  struct list l;
+  list_create_with_allocator(&l, list_node_cache_allocator(cache));
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    list_push_front(&l, i);
+  }
+  EXPECT_GT(list_node_cache_memory(cache), 0u);
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    EXPECT_EQ(list_get(&l, i), BIG_SIZE - 1 - i);
+  }
+
+  // the nodes are reused
+  list_destroy(&l);
+  std::size_t memory = list_node_cache_memory(cache);
+  list_create_with_allocator(&l, list_node_cache_allocator(cache));
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    list_push_front(&l, i);
+  }
+  EXPECT_EQ(list_node_cache_memory(cache), memory);
+  list_destroy(&l);
+
+  list_node_cache_destroy(cache);
+}
+
+TEST(NodeCacheTest, Capacity) {
+  const std::size_t capacity = 1000;
+  struct list_node_cache *cache = list_node_cache_create(capacity, 0);
+  struct list l;
+  list_create_with_allocator(&l, list_node_cache_allocator(cache));
+  for (int i = 0; i < 100 * BIG_SIZE; ++i) {
+    list_push_front(&l, i);
+  }
+  std::size_t nodes_per_block = LIST_NODE_CACHE_BLOCK_SIZE / sizeof(struct list_node);
+  EXPECT_GE(list_node_cache_memory(cache), 100 * BIG_SIZE / nodes_per_block * LIST_NODE_CACHE_BLOCK_SIZE);
+
+  list_destroy(&l);
+  EXPECT_LE(list_node_cache_memory(cache), (capacity / nodes_per_block + 2) * LIST_NODE_CACHE_BLOCK_SIZE);
+  list_node_cache_destroy(cache);
+}
+
+TEST(NodeCacheTest, RemoteFree) {
+  struct list_node_cache *cache = list_node_cache_create(0, 16);
+  const int threads = 4;
+  std::vector<struct list> lists(threads);
+  for (auto &l : lists) {
+    list_create_with_allocator(&l, list_node_cache_allocator(cache));
+  }
+
+  // each thread builds a list, then destroys the list of the next one
+  std::vector<std::thread> workers;
+  std::atomic<int> built(0);
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t]() {
+      for (int i = 0; i < BIG_SIZE; ++i) {
+        list_push_front(&lists[t], t * BIG_SIZE + i);
+      }
+      ++built;
+      while (built.load() < threads) {
+        std::this_thread::yield();
+      }
+      struct list &other = lists[(t + 1) % threads];
+      EXPECT_EQ(list_size(&other), std::size_t(BIG_SIZE));
+      EXPECT_EQ(other.first->data, ((t + 1) % threads) * BIG_SIZE + BIG_SIZE - 1);
+      list_destroy(&other);
+      list_node_cache_flush(cache);
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // all the threads have exited and all the nodes are free
+  list_node_cache_flush(cache);
+  EXPECT_EQ(list_node_cache_memory(cache), 0u);
+  list_node_cache_destroy(cache);
+}
+
+TEST(NodeCacheTest, Orphan) {
+  struct list_node_cache *cache = list_node_cache_create(0, 0);
+  struct list l;
+  list_create_with_allocator(&l, list_node_cache_allocator(cache));
+  std::thread producer([&]() {
+    for (int i = 0; i < BIG_SIZE; ++i) {
+      list_push_front(&l, i);
+    }
+  });
+  producer.join();
+
+  // the blocks outlive their thread until their nodes are freed
+  EXPECT_GT(list_node_cache_memory(cache), 0u);
+  EXPECT_EQ(list_size(&l), std::size_t(BIG_SIZE));
+  list_destroy(&l);
+  list_node_cache_flush(cache);
+  EXPECT_EQ(list_node_cache_memory(cache), 0u);
+  list_node_cache_destroy(cache);
+}
+
+/*
+ * list_log
+ */
+
+class ListLogTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path = ::testing::TempDir() + "list_log_" + std::to_string(getpid()) + "_"
+      + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    remove_files();
+  }
+
+  void TearDown() override { remove_files(); }
+
+  void remove_files() {
+    std::remove(path.c_str());
+    std::remove((path + ".checkpoint").c_str());
+    std::remove((path + ".checkpoint.tmp").c_str());
+  }
+
+  std::string read(const std::string &file) {
+    std::ifstream in(file, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+
+  void write(const std::string &file, const std::string &content) {
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    out << content;
+  }
+
+  std::vector<int> recover() {
+    struct list l;
+    list_create(&l);
+    struct list_log *log = list_log_open(&l, path.c_str(), 0);
+    EXPECT_NE(log, nullptr);
+    std::vector<int> values = list_values(&l);
+    if (log != nullptr) {
+      list_log_close(log);
+    }
+    list_destroy(&l);
+    return values;
+  }
+
+  std::string path;
+};
+
+TEST_F(ListLogTest, RoundTrip) {
+  static const int expected[] = { -7, 1, 2, 3, 2000000000 };
+  struct list l;
+  list_create(&l);
+  struct list_log *log = list_log_open(&l, path.c_str(), 4);
+  ASSERT_NE(log, nullptr);
+  EXPECT_TRUE(list_empty(&l));
+
+  EXPECT_TRUE(list_log_push_back(log, 3));
+  EXPECT_TRUE(list_log_push_front(log, 1));
+  EXPECT_TRUE(list_log_push_front(log, 9));
+  EXPECT_TRUE(list_log_insert(log, 5, 2));
+  EXPECT_TRUE(list_log_set(log, 2, 2));
+  EXPECT_TRUE(list_log_pop_front(log));
+  EXPECT_TRUE(list_log_push_back(log, -7));
+  EXPECT_TRUE(list_log_push_back(log, 2000000000));
+  EXPECT_TRUE(list_log_push_back(log, 4));
+  EXPECT_TRUE(list_log_pop_back(log));
+  EXPECT_TRUE(list_log_merge_sort(log));
+  EXPECT_TRUE(list_log_insert(log, 8, 1));
+  EXPECT_TRUE(list_log_remove(log, 1));
+  EXPECT_TRUE(list_equals(&l, expected, std::size(expected)));
+  EXPECT_TRUE(list_log_close(log));
+  list_destroy(&l);
+
+  std::vector<int> recovered = recover();
+  EXPECT_EQ(recovered, std::vector<int>(std::begin(expected), std::end(expected)));
+
+  // a reopened log goes on
+  list_create(&l);
+  log = list_log_open(&l, path.c_str(), 0);
+  ASSERT_NE(log, nullptr);
+  EXPECT_TRUE(list_log_clear(log));
+  EXPECT_TRUE(list_log_push_back(log, 42));
+  EXPECT_TRUE(list_log_close(log));
+  list_destroy(&l);
+  EXPECT_EQ(recover(), std::vector<int>({ 42 }));
+}
+
+TEST_F(ListLogTest, GroupCommit) {
+  struct list l;
+  list_create(&l);
+  struct list_log *log = list_log_open(&l, path.c_str(), 3);
+  ASSERT_NE(log, nullptr);
+  std::size_t empty = list_log_size(log);
+
+  list_log_push_back(log, 1);
+  list_log_push_back(log, 2);
+  EXPECT_EQ(list_log_size(log), empty);
+  list_log_push_back(log, 3);
+  std::size_t one_frame = list_log_size(log);
+  EXPECT_GT(one_frame, empty);
+  list_log_push_back(log, 4);
+  EXPECT_EQ(list_log_size(log), one_frame);
+  EXPECT_TRUE(list_log_commit(log));
+  EXPECT_GT(list_log_size(log), one_frame);
+
+  // the records are compact: one byte of opcode and one of value here
+  EXPECT_EQ(one_frame - empty, 8u + 3 * 2);
+  list_log_close(log);
+  list_destroy(&l);
+}
+
+TEST_F(ListLogTest, Checkpoint) {
+  struct list l;
+  list_create(&l);
+  struct list_log *log = list_log_open(&l, path.c_str(), 1);
+  ASSERT_NE(log, nullptr);
+  std::size_t empty = list_log_size(log);
+  for (int i = 0; i < BIG_SIZE; ++i) {
+    list_log_push_front(log, i);
+  }
+  EXPECT_GT(list_log_size(log), empty);
+  EXPECT_TRUE(list_log_checkpoint(log));
+  EXPECT_EQ(list_log_size(log), empty);
+
+  list_log_set(log, 0, -1);
+  list_log_pop_back(log);
+  std::vector<int> expected = list_values(&l);
+  list_log_close(log);
+  list_destroy(&l);
+  EXPECT_EQ(recover(), expected);
+
+  // a second checkpoint replaces the first
+  list_create(&l);
+  log = list_log_open(&l, path.c_str(), 1);
+  ASSERT_NE(log, nullptr);
+  list_log_clear(log);
+  list_log_push_back(log, 7);
+  EXPECT_TRUE(list_log_checkpoint(log));
+  list_log_close(log);
+  list_destroy(&l);
+  EXPECT_EQ(recover(), std::vector<int>({ 7 }));
+}
+
+TEST_F(ListLogTest, TornLog) {
+  struct list l;
+  list_create(&l);
+  struct list_log *log = list_log_open(&l, path.c_str(), 1);
+  ASSERT_NE(log, nullptr);
+
+  // the state after each frame and the size of the log then
+  std::vector<std::pair<std::size_t, std::vector<int>>> states;
+  states.emplace_back(list_log_size(log), list_values(&l));
+  std::srand(40);
+  for (int i = 0; i < 30; ++i) {
+    std::size_t size = list_size(&l);
+    if (size > 0 && std::rand() % 3 == 0) {
+      list_log_remove(log, std::rand() % size);
+    } else {
+      list_log_insert(log, std::rand() - RAND_MAX / 2, std::rand() % (size + 1));
+    }
+    states.emplace_back(list_log_size(log), list_values(&l));
+  }
+  list_log_close(log);
+  list_destroy(&l);
+  std::string full = read(path);
+
+  // crash at every byte: recovery gives the last complete frame
+  for (std::size_t cut = 0; cut <= full.size(); ++cut) {
+    write(path, full.substr(0, cut));
+    auto state = states.begin();
+    while (std::next(state) != states.end() && std::next(state)->first <= cut) {
+      ++state;
+    }
+    EXPECT_EQ(recover(), state->second) << "cut at " << cut;
+    if (cut >= states.front().first) {
+      // the torn tail was dropped
+      EXPECT_EQ(read(path).size(), state->first);
+    }
+  }
+}
+
+TEST_F(ListLogTest, CorruptFrame) {
+  struct list l;
+  list_create(&l);
+  struct list_log *log = list_log_open(&l, path.c_str(), 1);
+  ASSERT_NE(log, nullptr);
+  list_log_push_back(log, 1);
+  std::size_t first_frame = list_log_size(log);
+  list_log_push_back(log, 2);
+  list_log_push_back(log, 3);
+  list_log_close(log);
+  list_destroy(&l);
+
+  std::string content = read(path);
+  content[first_frame + 8] ^= 0x40;
+  write(path, content);
+  EXPECT_EQ(recover(), std::vector<int>({ 1 }));
+}
+
+TEST_F(ListLogTest, InvalidRecordDropsWholeFrame) {
+  struct list l;
+  list_create(&l);
+  struct list_log *log = list_log_open(&l, path.c_str(), 1);
+  ASSERT_NE(log, nullptr);
+  list_log_push_back(log, 1);
+  std::size_t valid = list_log_size(log);
+  list_log_close(log);
+  list_destroy(&l);
+
+  // a frame with a good CRC: push_back 5, then remove at 7, out of range
+  const std::string payload = { 3, 10, 6, 7 };
+  std::uint32_t crc = 0xffffffffu;
+  for (unsigned char byte : payload) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320u : crc >> 1;
+    }
+  }
+  crc ^= 0xffffffffu;
+  std::string frame;
+  for (std::uint32_t field : { static_cast<std::uint32_t>(payload.size()), crc }) {
+    for (int i = 0; i < 4; ++i) {
+      frame += static_cast<char>(field >> (8 * i));
+    }
+  }
+  write(path, read(path) + frame + payload);
+
+  EXPECT_EQ(recover(), std::vector<int>({ 1 }));
+  EXPECT_EQ(read(path).size(), valid);
+}
+
+TEST_F(ListLogTest, StaleLogAfterCheckpoint) {
+  struct list l;
+  list_create(&l);
+  struct list_log *log = list_log_open(&l, path.c_str(), 1);
+  ASSERT_NE(log, nullptr);
+  list_log_push_back(log, 1);
+  list_log_push_back(log, 2);
+  std::string old_log = read(path);
+  EXPECT_TRUE(list_log_checkpoint(log));
+  list_log_close(log);
+  list_destroy(&l);
+
+  // crash after the rename of the checkpoint, before the reset of the log
+  write(path, old_log);
+  EXPECT_EQ(recover(), std::vector<int>({ 1, 2 }));
+}
+
+/*
+ * rcu_list
+ */
+
+static bool collect_value(int value, void *ctx) {
+  static_cast<std::vector<int> *>(ctx)->push_back(value);
+  return true;
+}
+
+static std::vector<int> rcu_values(struct rcu_list *l) {
+  std::vector<int> values;
+  rcu_list_for_each(l, collect_value, &values);
+  return values;
+}
+
+TEST(RcuListTest, Sequential) {
+  struct rcu_list *l = rcu_list_create();
+  ASSERT_NE(l, nullptr);
+  EXPECT_EQ(rcu_list_size(l), 0u);
+  rcu_list_pop_front(l);
+  rcu_list_pop_back(l);
+
+  rcu_list_push_back(l, 2);
+  rcu_list_push_front(l, 1);
+  rcu_list_push_back(l, 4);
+  rcu_list_insert(l, 3, 2);
+  EXPECT_EQ(rcu_values(l), std::vector<int>({ 1, 2, 3, 4 }));
+  EXPECT_EQ(rcu_list_size(l), 4u);
+  EXPECT_EQ(rcu_list_get(l, 2), 3);
+  EXPECT_EQ(rcu_list_get(l, 10), 0);
+  EXPECT_EQ(rcu_list_search(l, 4), 3u);
+  EXPECT_EQ(rcu_list_search(l, 5), 4u);
+
+  rcu_list_set(l, 0, 10);
+  rcu_list_remove(l, 1);
+  rcu_list_pop_back(l);
+  rcu_list_pop_front(l);
+  EXPECT_EQ(rcu_values(l), std::vector<int>({ 3 }));
+
+  rcu_list_synchronize(l);
+  EXPECT_EQ(rcu_list_pending(l), 0u);
+  rcu_list_destroy(l);
+}
+
+TEST(RcuListTest, Traversal) {
+  struct rcu_list *l = rcu_list_create();
+  for (int i = 0; i < 5; ++i) {
+    rcu_list_push_back(l, i);
+  }
+  int expected = 0;
+  rcu_list_read_lock(l);
+  rcu_list_read_lock(l); // nested
+  for (const struct list_node *curr = rcu_list_first(l); curr != nullptr; curr = rcu_list_next(curr)) {
+    EXPECT_EQ(curr->data, expected++);
+  }
+  rcu_list_read_unlock(l);
+  rcu_list_read_unlock(l);
+  EXPECT_EQ(expected, 5);
+  rcu_list_destroy(l);
+}
+
+TEST(RcuListTest, GracePeriod) {
+  struct rcu_list *l = rcu_list_create();
+  rcu_list_push_back(l, 1);
+  rcu_list_push_back(l, 2);
+
+  std::atomic<int> step(0);
+  std::thread reader([&]() {
+    rcu_list_read_lock(l);
+    const struct list_node *first = rcu_list_first(l);
+    step = 1;
+    while (step.load() < 2) {
+      std::this_thread::yield();
+    }
+    // removed meanwhile, but still readable and still linked to the rest
+    EXPECT_EQ(first->data, 1);
+    EXPECT_EQ(rcu_list_next(first)->data, 2);
+    rcu_list_read_unlock(l);
+  });
+
+  while (step.load() < 1) {
+    std::this_thread::yield();
+  }
+  rcu_list_pop_front(l);
+  rcu_list_set(l, 0, 3);
+  EXPECT_EQ(rcu_list_pending(l), 2u);
+  EXPECT_EQ(rcu_values(l), std::vector<int>({ 3 }));
+  step = 2;
+  reader.join();
+
+  rcu_list_synchronize(l);
+  EXPECT_EQ(rcu_list_pending(l), 0u);
+  rcu_list_destroy(l);
+}
+
+TEST(RcuListTest, ConcurrentReaders) {
+  struct rcu_list *l = rcu_list_create();
+  for (int i = 0; i < 100; ++i) {
+    rcu_list_push_back(l, 2 * i);
+  }
+
+  // the writer keeps the list sorted, the readers check it on every pass
+  std::atomic<bool> done(false);
+  std::atomic<int> failures(0);
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; ++t) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        rcu_list_read_lock(l);
+        int previous = -1;
+        for (const struct list_node *curr = rcu_list_first(l); curr != nullptr; curr = rcu_list_next(curr)) {
+          if (curr->data <= previous) {
+            ++failures;
+          }
+          previous = curr->data;
+        }
+        rcu_list_read_unlock(l);
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  std::srand(41);
+  for (int i = 0; i < 2000; ++i) {
+    std::size_t index = std::rand() % 99;
+    int before = index == 0 ? -1 : rcu_list_get(l, index - 1);
+    int after = rcu_list_get(l, index + 1);
+    if (after - before > 1) {
+      rcu_list_set(l, index, before + 1 + std::rand() % (after - before - 1));
+    }
+    rcu_list_remove(l, 99);
+    rcu_list_push_back(l, rcu_list_get(l, 98) + 1 + std::rand() % 3);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(failures.load(), 0);
+  EXPECT_EQ(rcu_list_size(l), 100u);
+  rcu_list_destroy(l);
+}
+
+/*
+ * list_fingerprint
+ */
+
+static void expect_fingerprint_matches(const struct list *l, const std::vector<int> &values) {
+  EXPECT_EQ(list_size(l), values.size());
+  EXPECT_EQ(list_fingerprint_hash(l), list_fingerprint_array(values.data(), values.size()));
+  int min = 0;
+  int max = 0;
+  EXPECT_EQ(list_min_max(l, &min, &max), !values.empty());
+  if (!values.empty()) {
+    EXPECT_EQ(min, *std::min_element(values.begin(), values.end()));
+    EXPECT_EQ(max, *std::max_element(values.begin(), values.end()));
+  }
+}
+
+TEST(ListFingerprintTest, Attach) {
+  static const int data[] = { 3, 1, 4, 1, 5 };
+  struct list l;
+  list_create_from(&l, data, std::size(data));
+  uint64_t walked = list_fingerprint_hash(&l);
+  std::size_t size = 0;
+  EXPECT_FALSE(list_fingerprint_size(&l, &size));
+
+  ASSERT_TRUE(list_fingerprint_attach(&l));
+  EXPECT_TRUE(list_fingerprint_size(&l, &size));
+  EXPECT_EQ(size, std::size(data));
+  EXPECT_EQ(list_fingerprint_hash(&l), walked);
+  EXPECT_EQ(walked, list_fingerprint_array(data, std::size(data)));
+
+  // order sensitive
+  static const int swapped[] = { 1, 3, 4, 1, 5 };
+  EXPECT_NE(walked, list_fingerprint_array(swapped, std::size(swapped)));
+  list_destroy(&l);
+}
+
+TEST(ListFingerprintTest, Random) {
+  struct list l;
+  list_create(&l);
+  ASSERT_TRUE(list_fingerprint_attach(&l));
+  std::vector<int> values;
+
+  std::srand(42);
+  for (int i = 0; i < 3000; ++i) {
+    int value = std::rand() % 64 - 32;
+    std::size_t size = values.size();
+    switch (std::rand() % 8) {
+    case 0:
+      list_push_front(&l, value);
+      values.insert(values.begin(), value);
+      break;
+    case 1:
+      list_push_back(&l, value);
+      values.push_back(value);
+      break;
+    case 2: {
+      std::size_t index = std::rand() % (size + 1);
+      list_insert(&l, value, index);
+      values.insert(values.begin() + index, value);
+      break;
+    }
+    case 3:
+      if (size > 0) {
+        std::size_t index = std::rand() % size;
+        list_remove(&l, index);
+        values.erase(values.begin() + index);
+      }
+      break;
+    case 4:
+      if (size > 0) {
+        std::size_t index = std::rand() % size;
+        list_set(&l, index, value);
+        values[index] = value;
+      }
+      break;
+    case 5:
+      list_pop_front(&l);
+      if (size > 0) {
+        values.erase(values.begin());
+      }
+      break;
+    case 6:
+      list_pop_back(&l);
+      if (size > 0) {
+        values.pop_back();
+      }
+      break;
+    default:
+      if (size > 0) {
+        std::size_t from = std::rand() % size;
+        std::size_t to = std::rand() % size;
+        list_insert_node(&l, list_extract(&l, from), to);
+        int moved = values[from];
+        values.erase(values.begin() + from);
+        values.insert(values.begin() + to, moved);
+      }
+      break;
+    }
+    if (i % 50 == 0) {
+      expect_fingerprint_matches(&l, values);
+    }
+  }
+  expect_fingerprint_matches(&l, values);
+
+  list_merge_sort(&l);
+  std::sort(values.begin(), values.end());
+  expect_fingerprint_matches(&l, values);
+  list_reverse(&l);
+  std::reverse(values.begin(), values.end());
+  expect_fingerprint_matches(&l, values);
+  list_destroy(&l);
+}
+
+TEST(ListFingerprintTest, MinMaxStale) {
+  static const int data[] = { 5, 1, 9 };
+  struct list l;
+  list_create_from(&l, data, std::size(data));
+  list_fingerprint_attach(&l);
+  int min = 0;
+  int max = 0;
+  list_pop_back(&l); // removes the maximum
+  EXPECT_TRUE(list_min_max(&l, &min, &max));
+  EXPECT_EQ(min, 1);
+  EXPECT_EQ(max, 5);
+  list_set(&l, 1, 7);
+  list_push_front(&l, 0);
+  EXPECT_TRUE(list_min_max(&l, &min, &max));
+  EXPECT_EQ(min, 0);
+  EXPECT_EQ(max, 7);
+  list_pop_front(&l);
+  list_pop_front(&l);
+  list_pop_front(&l);
+  EXPECT_FALSE(list_min_max(&l, &min, &max));
+  list_push_back(&l, -3);
+  EXPECT_TRUE(list_min_max(&l, &min, &max));
+  EXPECT_EQ(min, -3);
+  EXPECT_EQ(max, -3);
+  list_destroy(&l);
+}
+
+TEST(ListFingerprintTest, EqualsList) {
+  static const int data[] = { 1, 2, 3 };
+  static const int reordered[] = { 3, 2, 1 };
+  struct list l1;
+  struct list l2;
+  list_create_from(&l1, data, std::size(data));
+  list_create_from(&l2, data, std::size(data));
+  EXPECT_TRUE(list_equals_list(&l1, &l2));
+
+  list_fingerprint_attach(&l1);
+  EXPECT_TRUE(list_equals_list(&l1, &l2));
+  list_fingerprint_attach(&l2);
+  EXPECT_TRUE(list_equals_list(&l1, &l2));
+  EXPECT_FALSE(list_fingerprint_differ(&l1, &l2));
+
+  list_push_back(&l2, 4);
+  EXPECT_TRUE(list_fingerprint_differ(&l1, &l2));
+  EXPECT_FALSE(list_equals_list(&l1, &l2));
+  EXPECT_FALSE(list_equals(&l2, data, std::size(data)));
+  list_pop_back(&l2);
+  EXPECT_TRUE(list_equals_list(&l1, &l2));
+
+  list_destroy(&l2);
+  list_create_from(&l2, reordered, std::size(reordered));
+  list_fingerprint_attach(&l2);
+  EXPECT_TRUE(list_fingerprint_differ(&l1, &l2));
+  EXPECT_FALSE(list_equals_list(&l1, &l2));
+
+  list_destroy(&l1);
+  list_destroy(&l2);
+}
+
+/*
+ * list_cache
+ */
+
+TEST(ListCacheTest, LeastRecentlyUsed) {
+  struct list_cache *cache = list_cache_create(3, LIST_CACHE_ENTRIES, LIST_CACHE_LRU);
+  ASSERT_NE(cache, nullptr);
+  EXPECT_TRUE(list_cache_put(cache, 1, 10, 0));
+  EXPECT_TRUE(list_cache_put(cache, 2, 20, 0));
+  EXPECT_TRUE(list_cache_put(cache, 3, 30, 0));
+
+  int value = 0;
+  EXPECT_TRUE(list_cache_get(cache, 1, &value));
+  EXPECT_EQ(value, 10);
+  EXPECT_TRUE(list_cache_put(cache, 4, 40, 0)); // evicts 2
+  EXPECT_FALSE(list_cache_contains(cache, 2));
+  EXPECT_FALSE(list_cache_get(cache, 2, &value));
+
+  EXPECT_TRUE(list_cache_put(cache, 3, 33, 0)); // update, 1 is now the oldest
+  EXPECT_TRUE(list_cache_put(cache, 5, 50, 0));
+  EXPECT_FALSE(list_cache_contains(cache, 1));
+  EXPECT_TRUE(list_cache_get(cache, 3, &value));
+  EXPECT_EQ(value, 33);
+  EXPECT_EQ(list_cache_size(cache), 3u);
+  EXPECT_EQ(list_cache_usage(cache), 3u);
+
+  struct list_cache_stats stats = list_cache_stats(cache);
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.insertions, 5u);
+  EXPECT_EQ(stats.evictions, 2u);
+  EXPECT_EQ(stats.promotions, 0u);
+
+  EXPECT_TRUE(list_cache_remove(cache, 4));
+  EXPECT_FALSE(list_cache_remove(cache, 4));
+  EXPECT_EQ(list_cache_size(cache), 2u);
+  list_cache_clear(cache);
+  EXPECT_EQ(list_cache_size(cache), 0u);
+  EXPECT_EQ(list_cache_usage(cache), 0u);
+  EXPECT_FALSE(list_cache_contains(cache, 3));
+  list_cache_destroy(cache);
+}
+
+TEST(ListCacheTest, Bytes) {
+  struct list_cache *cache = list_cache_create(1000, LIST_CACHE_BYTES, LIST_CACHE_LRU);
+  EXPECT_FALSE(list_cache_put(cache, 0, 0, 1000));
+  EXPECT_TRUE(list_cache_put(cache, 1, 1, 400));
+  EXPECT_TRUE(list_cache_put(cache, 2, 2, 400));
+  std::size_t overhead = list_cache_usage(cache) / 2 - 400;
+  EXPECT_GT(overhead, 0u);
+  EXPECT_TRUE(list_cache_put(cache, 3, 3, 400)); // evicts 1
+  EXPECT_FALSE(list_cache_contains(cache, 1));
+  EXPECT_TRUE(list_cache_put(cache, 2, 2, 900)); // grows 2, evicts 3
+  EXPECT_EQ(list_cache_size(cache), 1u);
+  EXPECT_EQ(list_cache_usage(cache), 900 + overhead);
+  EXPECT_TRUE(list_cache_contains(cache, 2));
+  list_cache_destroy(cache);
+}
+
+TEST(ListCacheTest, ScanResistance) {
+  for (list_cache_policy policy : { LIST_CACHE_LRU, LIST_CACHE_2Q }) {
+    struct list_cache *cache = list_cache_create(8, LIST_CACHE_ENTRIES, policy);
+    for (int key = 0; key < 4; ++key) {
+      list_cache_put(cache, key, key, 0);
+      list_cache_get(cache, key, nullptr);
+    }
+    for (int key = 100; key < 200; ++key) {
+      list_cache_put(cache, key, key, 0);
+    }
+    std::size_t hot = 0;
+    for (int key = 0; key < 4; ++key) {
+      hot += list_cache_contains(cache, key);
+    }
+    EXPECT_EQ(hot, policy == LIST_CACHE_2Q ? 4u : 0u);
+    EXPECT_EQ(list_cache_size(cache), 8u);
+    EXPECT_EQ(list_cache_stats(cache).promotions, policy == LIST_CACHE_2Q ? 4u : 0u);
+    list_cache_destroy(cache);
+  }
+}
+
+TEST(ListCacheTest, RandomLeastRecentlyUsed) {
+  const std::size_t capacity = 16;
+  struct list_cache *cache = list_cache_create(capacity, LIST_CACHE_ENTRIES, LIST_CACHE_LRU);
+  std::vector<std::pair<int, int>> model; // most recently used first
+
+  std::srand(43);
+  for (int i = 0; i < 5000; ++i) {
+    int key = std::rand() % 40;
+    auto found = std::find_if(model.begin(), model.end(), [key](const std::pair<int, int> &entry) {
+      return entry.first == key;
+    });
+    switch (std::rand() % 3) {
+    case 0: {
+      int value = 0;
+      EXPECT_EQ(list_cache_get(cache, key, &value), found != model.end());
+      if (found != model.end()) {
+        EXPECT_EQ(value, found->second);
+        std::rotate(model.begin(), found, found + 1);
+      }
+      break;
+    }
+    case 1: {
+      int value = std::rand();
+      EXPECT_TRUE(list_cache_put(cache, key, value, 0));
+      if (found != model.end()) {
+        model.erase(found);
+      }
+      model.insert(model.begin(), { key, value });
+      if (model.size() > capacity) {
+        model.pop_back();
+      }
+      break;
+    }
+    default:
+      EXPECT_EQ(list_cache_remove(cache, key), found != model.end());
+      if (found != model.end()) {
+        model.erase(found);
+      }
+      break;
+    }
+    ASSERT_EQ(list_cache_size(cache), model.size());
+  }
+  for (int key = 0; key < 40; ++key) {
+    bool present = std::any_of(model.begin(), model.end(), [key](const std::pair<int, int> &entry) {
+      return entry.first == key;
+    });
+    EXPECT_EQ(list_cache_contains(cache, key), present);
+  }
+  list_cache_destroy(cache);
+}
+
+/*
+ * adaptive_list
+ */
+
+static std::vector<int> adaptive_values(struct adaptive_list *l) {
+  std::vector<int> values;
+  for (std::size_t i = 0; i < adaptive_list_size(l); ++i) {
+    values.push_back(adaptive_list_get(l, i));
+  }
+  return values;
+}
+
+TEST(AdaptiveListTest, IndexedMigratesToArray) {
+  std::vector<int> values(1000);
+  std::iota(values.begin(), values.end(), 0);
+  struct adaptive_list l;
+  adaptive_list_create_from(&l, values.data(), values.size());
+  EXPECT_FALSE(adaptive_list_contiguous(&l));
+
+  std::srand(44);
+  for (int i = 0; i < 200; ++i) {
+    std::size_t index = std::rand() % values.size();
+    EXPECT_EQ(adaptive_list_get(&l, index), values[index]);
+  }
+  EXPECT_TRUE(adaptive_list_contiguous(&l));
+  const struct adaptive_list_stats *stats = adaptive_list_stats(&l);
+  EXPECT_EQ(stats->to_array, 1u);
+  EXPECT_EQ(stats->to_linked, 0u);
+  EXPECT_EQ(stats->last_reason, ADAPTIVE_LIST_REASON_INDEXED);
+  EXPECT_EQ(stats->migrations[ADAPTIVE_LIST_REASON_INDEXED], 1u);
+  EXPECT_LE(stats->last_migration, 200u);
+  EXPECT_EQ(stats->indexed, 200u);
+
+  adaptive_list_set(&l, 10, -1);
+  adaptive_list_insert(&l, -2, 500);
+  values[10] = -1;
+  values.insert(values.begin() + 500, -2);
+  EXPECT_TRUE(adaptive_list_equals(&l, values.data(), values.size()));
+  adaptive_list_destroy(&l);
+}
+
+TEST(AdaptiveListTest, SplicesMigrateToLinked) {
+  struct adaptive_list_tuning tuning = adaptive_list_default_tuning();
+  tuning.node_cost = 1;
+  tuning.move_divisor = 1;
+  tuning.window = 16;
+  struct adaptive_list l;
+  adaptive_list_create_with_tuning(&l, &tuning);
+  std::vector<int> values;
+  for (int i = 0; i < 1000; ++i) {
+    adaptive_list_push_front(&l, i);
+    values.insert(values.begin(), i);
+  }
+  for (int i = 0; i < 100 && !adaptive_list_contiguous(&l); ++i) {
+    adaptive_list_get(&l, values.size() - 1);
+  }
+  ASSERT_TRUE(adaptive_list_contiguous(&l));
+
+  // the gap buffer moves every value between the two ends
+  for (int i = 0; i < 100; ++i) {
+    adaptive_list_insert(&l, i, 1);
+    values.insert(values.begin() + 1, i);
+    adaptive_list_pop_back(&l);
+    values.pop_back();
+  }
+  EXPECT_FALSE(adaptive_list_contiguous(&l));
+  const struct adaptive_list_stats *stats = adaptive_list_stats(&l);
+  EXPECT_EQ(stats->to_linked, 1u);
+  EXPECT_EQ(stats->last_reason, ADAPTIVE_LIST_REASON_SPLICES);
+  EXPECT_EQ(adaptive_values(&l), values);
+  adaptive_list_destroy(&l);
+}
+
+TEST(AdaptiveListTest, List) {
+  static const int data[] = { 1, 2, 3 };
+  static const int expected[] = { 0, 1, 2, 3, 4 };
+  struct adaptive_list_tuning tuning = adaptive_list_default_tuning();
+  tuning.min_size = 0;
+  tuning.window = 8;
+  struct adaptive_list l;
+  adaptive_list_create_with_tuning(&l, &tuning);
+  for (int value : data) {
+    adaptive_list_push_back(&l, value);
+  }
+  for (int i = 0; i < 100 && !adaptive_list_contiguous(&l); ++i) {
+    adaptive_list_get(&l, 2);
+  }
+  ASSERT_TRUE(adaptive_list_contiguous(&l));
+
+  struct list *linked = adaptive_list_list(&l);
+  EXPECT_FALSE(adaptive_list_contiguous(&l));
+  EXPECT_EQ(adaptive_list_stats(&l)->last_reason, ADAPTIVE_LIST_REASON_LIST);
+  EXPECT_TRUE(list_equals(linked, data, std::size(data)));
+  list_push_front(linked, 0);
+  EXPECT_EQ(adaptive_list_size(&l), 4u);
+
+  adaptive_list_push_back(&l, 4);
+  EXPECT_TRUE(adaptive_list_equals(&l, expected, std::size(expected)));
+  adaptive_list_destroy(&l);
+}
+
+struct failing_allocator {
+  int remaining;
+};
+
+static struct list_node *failing_allocate(void *ctx) {
+  failing_allocator *self = static_cast<failing_allocator *>(ctx);
+  if (self->remaining == 0) return nullptr;
+  --self->remaining;
+  return static_cast<struct list_node *>(std::malloc(sizeof(struct list_node)));
+}
+
+static void failing_deallocate(void *, struct list_node *node) {
+  std::free(node);
+}
+
+TEST(AdaptiveListTest, FailedMigrationKeepsArray) {
+  std::vector<int> values(100);
+  std::iota(values.begin(), values.end(), 0);
+  struct adaptive_list_tuning tuning = adaptive_list_default_tuning();
+  tuning.min_size = 0;
+  tuning.window = 8;
+  struct adaptive_list l;
+  adaptive_list_create_with_tuning(&l, &tuning);
+  for (int value : values) {
+    adaptive_list_push_back(&l, value);
+  }
+  for (int i = 0; i < 100 && !adaptive_list_contiguous(&l); ++i) {
+    adaptive_list_get(&l, 50);
+  }
+  ASSERT_TRUE(adaptive_list_contiguous(&l));
+
+  failing_allocator state = { 10 };
+  struct list_allocator allocator = { failing_allocate, failing_deallocate, &state };
+  l.linked.allocator = &allocator;
+  EXPECT_EQ(adaptive_list_list(&l), nullptr);
+  EXPECT_TRUE(adaptive_list_contiguous(&l));
+  EXPECT_EQ(adaptive_list_stats(&l)->to_linked, 0u);
+  EXPECT_TRUE(adaptive_list_equals(&l, values.data(), values.size()));
+
+  l.linked.allocator = nullptr;
+  struct list *linked = adaptive_list_list(&l);
+  ASSERT_NE(linked, nullptr);
+  EXPECT_FALSE(adaptive_list_contiguous(&l));
+  EXPECT_TRUE(list_equals(linked, values.data(), values.size()));
+  adaptive_list_destroy(&l);
+}
+
+TEST(AdaptiveListTest, IndexKeepsLinked) {
+  std::vector<int> values(1000);
+  std::iota(values.begin(), values.end(), 0);
+  struct adaptive_list l;
+  adaptive_list_create_from(&l, values.data(), values.size());
+  ASSERT_TRUE(list_index_attach(adaptive_list_list(&l)));
+
+  for (int i = 0; i < 200; ++i) {
+    std::size_t index = (i * 7919) % values.size();
+    EXPECT_EQ(adaptive_list_get(&l, index), values[index]);
+  }
+  EXPECT_FALSE(adaptive_list_contiguous(&l));
+  EXPECT_EQ(adaptive_list_stats(&l)->to_array, 0u);
+  EXPECT_EQ(list_search(adaptive_list_list(&l), 600), 600u);
+  adaptive_list_destroy(&l);
+}
+
+TEST(AdaptiveListTest, Random) {
+  struct adaptive_list_tuning tuning;
+  tuning.window = 16;
+  tuning.min_size = 0;
+  tuning.node_cost = 1;
+  tuning.move_divisor = 1;
+  tuning.hysteresis = 0;
+  struct adaptive_list l;
+  adaptive_list_create_with_tuning(&l, &tuning);
+  std::vector<int> values;
+
+  std::srand(45);
+  for (int i = 0; i < 5000; ++i) {
+    int value = std::rand() % 100;
+    std::size_t size = values.size();
+    // alternate phases of indexed accesses and of splices at both ends
+    int op = std::rand() % 11;
+    if (op < 6) {
+      if ((i / 500) % 2 == 0) {
+        op = (op % 2 == 0) ? 7 : 10;
+      } else {
+        op = (op % 2 == 0) ? 0 : 6;
+      }
+    }
+    switch (op) {
+    case 0:
+      adaptive_list_push_front(&l, value);
+      values.insert(values.begin(), value);
+      break;
+    case 1:
+      adaptive_list_push_back(&l, value);
+      values.push_back(value);
+      break;
+    case 2:
+    case 3: {
+      std::size_t index = std::rand() % (size + 1);
+      adaptive_list_insert(&l, value, index);
+      values.insert(values.begin() + index, value);
+      break;
+    }
+    case 4:
+      if (size > 0) {
+        std::size_t index = std::rand() % size;
+        adaptive_list_remove(&l, index);
+        values.erase(values.begin() + index);
+      }
+      break;
+    case 5:
+      adaptive_list_pop_front(&l);
+      if (size > 0) {
+        values.erase(values.begin());
+      }
+      break;
+    case 6:
+      adaptive_list_pop_back(&l);
+      if (size > 0) {
+        values.pop_back();
+      }
+      break;
+    case 7:
+      if (size > 0) {
+        std::size_t index = std::rand() % size;
+        adaptive_list_set(&l, index, value);
+        values[index] = value;
+      }
+      break;
+    case 8: {
+      std::size_t index = std::find(values.begin(), values.end(), value) - values.begin();
+      EXPECT_EQ(adaptive_list_search(&l, value), index);
+      break;
+    }
+    case 9:
+      if (std::rand() % 20 == 0) {
+        adaptive_list_merge_sort(&l);
+        std::sort(values.begin(), values.end());
+      }
+      EXPECT_EQ(adaptive_list_is_sorted(&l), std::is_sorted(values.begin(), values.end()));
+      break;
+    default:
+      if (size > 0) {
+        std::size_t index = std::rand() % size;
+        EXPECT_EQ(adaptive_list_get(&l, index), values[index]);
+      }
+      break;
+    }
+    ASSERT_TRUE(adaptive_list_equals(&l, values.data(), values.size()));
+  }
+  const struct adaptive_list_stats *stats = adaptive_list_stats(&l);
+  EXPECT_GT(stats->to_array, 0u);
+  EXPECT_GT(stats->to_linked, 0u);
+  adaptive_list_destroy(&l);
+}
+
 int main(int argc, char *argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();